@@ -0,0 +1,245 @@
+/**
+ * PRIME IMPLICANT CHART
+ * Implements a sparse (CSR/CSC lists) and a dense (bitsets) representation of the
+ * prime implicant chart behind the same functions
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "linkedlist.h"
+#include "main.h"
+#include "chart.h"
+
+int compareInt(const void* a, const void* b) {
+    return *(const int*) a - *(const int*) b;
+}
+
+/**
+ * Calls cell(row, col) for every constraint covered by every implicant: the minterms
+ * of an implicant are its value combined with every subset of its dc mask
+*/
+void forEachCell(chart_t* implicantsChart, int* columnOf, int nOfVariables, void (*cell)(chart_t*, int, int)) {
+    for(int row = 0; row < implicantsChart->rows; row++) {
+        int value, dcMask, sub = 0;
+        decodeCube(implicantsChart->implicants[row], nOfVariables, &value, &dcMask);
+        do {
+            int col = columnOf[value | sub];
+            if(col != -1)
+                (*cell)(implicantsChart, row, col);
+            sub = (sub - dcMask) & dcMask;
+        } while(sub != 0);
+    }
+}
+
+void countCell(chart_t* implicantsChart, int row, int col) {
+    implicantsChart->rowCount[row]++;
+    implicantsChart->colCount[col]++;
+}
+
+/**
+ * Appends col to the list of row and row to the list of col. rowCount and colCount
+ * are used as insertion positions and end up counting the cells again
+*/
+void listCell(chart_t* implicantsChart, int row, int col) {
+    implicantsChart->rowIdx[implicantsChart->rowStart[row] + implicantsChart->rowCount[row]++] = col;
+    implicantsChart->colIdx[implicantsChart->colStart[col] + implicantsChart->colCount[col]++] = row;
+}
+
+void setCell(chart_t* implicantsChart, int row, int col) {
+    implicantsChart->rowBits[(size_t) row*implicantsChart->rowWords + col/64] |= (uint64_t) 1 << (col%64);
+    implicantsChart->colBits[(size_t) col*implicantsChart->colWords + row/64] |= (uint64_t) 1 << (row%64);
+}
+
+/**
+ * Returns a bitset of size bits all set to 1
+*/
+uint64_t* fullBitset(int size) {
+    int words = (size + 63) / 64;
+    uint64_t* bits = malloc(sizeof(uint64_t)*(words > 0 ? words : 1));
+    for(int w = 0; w < words; w++)
+        bits[w] = ~(uint64_t) 0;
+    if(size % 64)
+        bits[words-1] = ((uint64_t) 1 << (size%64)) - 1;
+    return bits;
+}
+
+chart_t* createChart(node_t* constraints, node_t* implicants, int nOfVariables) {
+    chart_t* implicantsChart = calloc(1, sizeof(chart_t));
+    int* columnOf = malloc(sizeof(int)*(1 << nOfVariables));
+    long long cells = 0;
+    int rows = length(implicants);
+    int cols = length(constraints);
+    int value, dcMask;
+
+    implicantsChart->rows = rows;
+    implicantsChart->columns = cols;
+    implicantsChart->implicants = malloc(sizeof(int)*(rows > 0 ? rows : 1));
+    implicantsChart->constraints = malloc(sizeof(int)*(cols > 0 ? cols : 1));
+    implicantsChart->rowCount = calloc(rows > 0 ? rows : 1, sizeof(int));
+    implicantsChart->colCount = calloc(cols > 0 ? cols : 1, sizeof(int));
+    implicantsChart->rowWords = (cols + 63) / 64;
+    implicantsChart->colWords = (rows + 63) / 64;
+    implicantsChart->rowActive = fullBitset(rows);
+    implicantsChart->colActive = fullBitset(cols);
+    for(int idx = 0; idx < (1 << nOfVariables); idx++)
+        columnOf[idx] = -1;
+    for(int col = 0; col < cols; col++, constraints = next(constraints)) {
+        implicantsChart->constraints[col] = getData(constraints);
+        decodeCube(implicantsChart->constraints[col], nOfVariables, &value, &dcMask);
+        columnOf[value] = col;
+    }
+    for(int row = 0; row < rows; row++, implicants = next(implicants))
+        implicantsChart->implicants[row] = getData(implicants);
+
+    forEachCell(implicantsChart, columnOf, nOfVariables, countCell);
+    for(int row = 0; row < rows; row++)
+        cells += implicantsChart->rowCount[row];
+    // a cell costs 2 ints inside the lists and 2 bits inside the bitsets
+#if defined(CHART_SPARSE)
+    implicantsChart->sparse = true;
+#elif defined(CHART_DENSE)
+    implicantsChart->sparse = false;
+#else
+    implicantsChart->sparse = cells * 32 < (long long) rows * cols;
+#endif
+    if(implicantsChart->sparse) {
+        implicantsChart->rowStart = malloc(sizeof(int)*(rows+1));
+        implicantsChart->colStart = malloc(sizeof(int)*(cols+1));
+        implicantsChart->rowStart[0] = implicantsChart->colStart[0] = 0;
+        for(int row = 0; row < rows; row++)
+            implicantsChart->rowStart[row+1] = implicantsChart->rowStart[row] + implicantsChart->rowCount[row];
+        for(int col = 0; col < cols; col++)
+            implicantsChart->colStart[col+1] = implicantsChart->colStart[col] + implicantsChart->colCount[col];
+        implicantsChart->rowIdx = malloc(sizeof(int)*(cells > 0 ? cells : 1));
+        implicantsChart->colIdx = malloc(sizeof(int)*(cells > 0 ? cells : 1));
+        for(int row = 0; row < rows; row++)
+            implicantsChart->rowCount[row] = 0;
+        for(int col = 0; col < cols; col++)
+            implicantsChart->colCount[col] = 0;
+        forEachCell(implicantsChart, columnOf, nOfVariables, listCell);
+        for(int row = 0; row < rows; row++) // columns are listed by index, the order of the constraints
+            qsort(implicantsChart->rowIdx + implicantsChart->rowStart[row], implicantsChart->rowCount[row], sizeof(int), compareInt);
+    } else {
+        implicantsChart->rowBits = calloc((size_t) rows*implicantsChart->rowWords + 1, sizeof(uint64_t));
+        implicantsChart->colBits = calloc((size_t) cols*implicantsChart->colWords + 1, sizeof(uint64_t));
+        forEachCell(implicantsChart, columnOf, nOfVariables, setCell);
+    }
+    free(columnOf);
+    return implicantsChart;
+}
+
+void freeChart(chart_t* implicantsChart) {
+    free(implicantsChart->implicants);
+    free(implicantsChart->constraints);
+    free(implicantsChart->rowCount);
+    free(implicantsChart->colCount);
+    free(implicantsChart->rowStart);
+    free(implicantsChart->rowIdx);
+    free(implicantsChart->colStart);
+    free(implicantsChart->colIdx);
+    free(implicantsChart->rowBits);
+    free(implicantsChart->colBits);
+    free(implicantsChart->rowActive);
+    free(implicantsChart->colActive);
+    free(implicantsChart);
+}
+
+/**
+ * Fills buffer with the indexes of the bits set inside bits & mask
+*/
+int bitsetIndexes(uint64_t* bits, uint64_t* mask, int words, int* buffer) {
+    int count = 0;
+    for(int w = 0; w < words; w++) {
+        uint64_t word = bits[w] & mask[w];
+        while(word != 0) {
+            buffer[count++] = w*64 + __builtin_ctzll(word);
+            word &= word - 1;
+        }
+    }
+    return count;
+}
+
+/**
+ * Returns true if bits & mask is contained inside bits2
+*/
+bool bitsetSubset(uint64_t* bits, uint64_t* bits2, uint64_t* mask, int words) {
+    for(int w = 0; w < words; w++) {
+        if(bits[w] & mask[w] & ~bits2[w])
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Returns true if every active element of list is contained inside list2.
+ * Both lists must be sorted; elements are active if their key isn't -1
+*/
+bool listSubset(int* list, int size, int* list2, int size2, int* keys) {
+    int j = 0;
+    for(int i = 0; i < size; i++) {
+        if(keys[list[i]] == -1)
+            continue;
+        while(j < size2 && list2[j] < list[i])
+            j++;
+        if(j == size2 || list2[j] != list[i])
+            return false;
+    }
+    return true;
+}
+
+int rowColumns(chart_t* implicantsChart, int row, int* buffer) {
+    if(!implicantsChart->sparse)
+        return bitsetIndexes(implicantsChart->rowBits + (size_t) row*implicantsChart->rowWords, implicantsChart->colActive, implicantsChart->rowWords, buffer);
+    int count = 0;
+    for(int idx = implicantsChart->rowStart[row]; idx < implicantsChart->rowStart[row+1]; idx++) {
+        if(implicantsChart->constraints[implicantsChart->rowIdx[idx]] != -1)
+            buffer[count++] = implicantsChart->rowIdx[idx];
+    }
+    return count;
+}
+
+int columnRows(chart_t* implicantsChart, int col, int* buffer) {
+    if(!implicantsChart->sparse)
+        return bitsetIndexes(implicantsChart->colBits + (size_t) col*implicantsChart->colWords, implicantsChart->rowActive, implicantsChart->colWords, buffer);
+    int count = 0;
+    for(int idx = implicantsChart->colStart[col]; idx < implicantsChart->colStart[col+1]; idx++) {
+        if(implicantsChart->implicants[implicantsChart->colIdx[idx]] != -1)
+            buffer[count++] = implicantsChart->colIdx[idx];
+    }
+    return count;
+}
+
+bool rowSubset(chart_t* implicantsChart, int row, int row2) {
+    if(implicantsChart->rowCount[row] > implicantsChart->rowCount[row2])
+        return false;
+    if(!implicantsChart->sparse) {
+        int words = implicantsChart->rowWords;
+        return bitsetSubset(implicantsChart->rowBits + (size_t) row*words, implicantsChart->rowBits + (size_t) row2*words, implicantsChart->colActive, words);
+    }
+    int* start = implicantsChart->rowStart;
+    return listSubset(implicantsChart->rowIdx + start[row], start[row+1] - start[row],
+                      implicantsChart->rowIdx + start[row2], start[row2+1] - start[row2], implicantsChart->constraints);
+}
+
+bool columnSubset(chart_t* implicantsChart, int col, int col2) {
+    if(implicantsChart->colCount[col] > implicantsChart->colCount[col2])
+        return false;
+    if(!implicantsChart->sparse) {
+        int words = implicantsChart->colWords;
+        return bitsetSubset(implicantsChart->colBits + (size_t) col*words, implicantsChart->colBits + (size_t) col2*words, implicantsChart->rowActive, words);
+    }
+    int* start = implicantsChart->colStart;
+    return listSubset(implicantsChart->colIdx + start[col], start[col+1] - start[col],
+                      implicantsChart->colIdx + start[col2], start[col2+1] - start[col2], implicantsChart->implicants);
+}
+
+void deactivateRow(chart_t* implicantsChart, int row) {
+    implicantsChart->implicants[row] = -1;
+    implicantsChart->rowActive[row/64] &= ~((uint64_t) 1 << (row%64));
+}
+
+void deactivateColumn(chart_t* implicantsChart, int col) {
+    implicantsChart->constraints[col] = -1;
+    implicantsChart->colActive[col/64] &= ~((uint64_t) 1 << (col%64));
+}
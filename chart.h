@@ -0,0 +1,76 @@
+#ifndef _CHART
+#define _CHART
+#include <stdint.h>
+
+/**
+ * Prime implicant chart: every row holds an implicant and every column a constraint.
+ * Sparse charts store the covered cells as sorted lists of column indexes for every row
+ * (CSR) and of row indexes for every column (CSC); dense charts store a bitset for every
+ * row and one for every column. Removed rows and columns have their implicant or
+ * constraint set to -1
+*/
+typedef struct chart {
+    int rows;
+    int columns;
+    int* implicants;    // implicant of every row
+    int* constraints;   // constraint of every column
+    int* rowCount;      // active constraints covered by every row
+    int* colCount;      // active implicants covering every column
+    bool sparse;
+    // sparse representation
+    int* rowStart;      // columns of row r are rowIdx[rowStart[r]..rowStart[r+1]-1]
+    int* rowIdx;
+    int* colStart;      // rows of column c are colIdx[colStart[c]..colStart[c+1]-1]
+    int* colIdx;
+    // dense representation
+    int rowWords;       // words of a row bitset
+    int colWords;       // words of a column bitset
+    uint64_t* rowBits;
+    uint64_t* colBits;
+    uint64_t* rowActive;
+    uint64_t* colActive;
+} chart_t;
+
+/**
+ * Returns the chart of passed implicants against passed constraints. Cells are found by
+ * expanding every implicant into its minterms, so building the chart costs as much as
+ * the number of covered cells. The representation using less memory is chosen, unless
+ * CHART_SPARSE or CHART_DENSE is defined at compile time to force one for testing
+*/
+chart_t* createChart(node_t* constraints, node_t* implicants, int nOfVariables);
+
+/**
+ * Frees passed chart
+*/
+void freeChart(chart_t* implicantsChart);
+
+/**
+ * Fills buffer with the active columns covered by row and returns how many they are
+*/
+int rowColumns(chart_t* implicantsChart, int row, int* buffer);
+
+/**
+ * Fills buffer with the active rows covering col and returns how many they are
+*/
+int columnRows(chart_t* implicantsChart, int col, int* buffer);
+
+/**
+ * Returns true if every active constraint covered by row is covered by row2 too
+*/
+bool rowSubset(chart_t* implicantsChart, int row, int row2);
+
+/**
+ * Returns true if every active implicant covering col covers col2 too
+*/
+bool columnSubset(chart_t* implicantsChart, int col, int col2);
+
+/**
+ * Marks passed row as removed
+*/
+void deactivateRow(chart_t* implicantsChart, int row);
+
+/**
+ * Marks passed column as removed
+*/
+void deactivateColumn(chart_t* implicantsChart, int col);
+#endif
@@ -0,0 +1,85 @@
+/**
+ * COST MODEL
+ * Cost of the implicants chosen by the Petrick method: every selection step minimizes
+ * the sum of the costs of the implicants of the cover
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "main.h"
+#include "cost.h"
+
+int costModelFromName(char* name) {
+    static const char* models[] = {"implicants", "literals", "gates"};
+    for(int idx = 0; idx < (int) (sizeof(models)/sizeof(models[0])); idx++) {
+        if(strcmp(name, models[idx]) == 0)
+            return idx;
+    }
+    return -1;
+}
+
+costModel_t* createCostModel(int type, char* weights, double sharedDiscount, int nOfVariables) {
+    costModel_t* model = malloc(sizeof(costModel_t));
+    char* cursor = weights;
+
+    model->type = type;
+    model->nOfVariables = nOfVariables;
+    model->weights = malloc(sizeof(double)*nOfVariables);
+    model->sharedDiscount = sharedDiscount;
+    model->shared = NULL;
+    model->nOfShared = 0;
+    // the first variable is the most significant pair
+    for(int var = 0; var < nOfVariables; var++) {
+        double weight = 1;
+        if(cursor != NULL && *cursor != '\0') {
+            char* end;
+            weight = strtod(cursor, &end);
+            if(end == cursor || weight < 0 || (*end != ',' && *end != '\0')) {
+                errno = EINVAL;
+                perror("Variable weights must be a comma separated list of non negative numbers");
+                exit(1);
+            }
+            cursor = *end == ',' ? end + 1 : end;
+        }
+        model->weights[nOfVariables-1-var] = weight;
+    }
+    return model;
+}
+
+int compareImplicants(const void* a, const void* b) {
+    int ia = *(const int*) a;
+    int ib = *(const int*) b;
+    return ia < ib ? -1 : ia > ib;
+}
+
+void setSharedImplicants(costModel_t* model, int* shared, int nOfShared) {
+    free(model->shared);
+    qsort(shared, nOfShared, sizeof(int), compareImplicants);
+    model->shared = shared;
+    model->nOfShared = nOfShared;
+}
+
+double implicantCost(costModel_t* model, int implicant) {
+    double literalsCost = 0;
+
+    if(model->type == COST_IMPLICANTS)
+        return 1;
+    for(int i = 0; i < model->nOfVariables; i++) {
+        if(((implicant >> (2*i)) & 0b11) != DC)
+            literalsCost += model->weights[i];
+    }
+    if(model->nOfShared > 0 && bsearch(&implicant, model->shared, model->nOfShared, sizeof(int), compareImplicants) != NULL)
+        literalsCost *= 1 - model->sharedDiscount;
+    if(model->type == COST_LITERALS)
+        return literalsCost;
+    // a single literal goes straight into the OR gate
+    return 1 + (literals(implicant) > 1 ? literalsCost : 0);
+}
+
+void freeCostModel(costModel_t* model) {
+    free(model->weights);
+    free(model->shared);
+    free(model);
+}
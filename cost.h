@@ -0,0 +1,57 @@
+#ifndef _COST
+#define _COST
+#include <stdbool.h>
+
+#define COST_IMPLICANTS 0   // every implicant costs 1
+#define COST_LITERALS 1     // every literal costs the weight of its variable
+#define COST_GATES 2        // gate inputs: an input of the OR gate for every implicant and
+                            // the literals of the AND gate of implicants with more than one
+
+#define COST_EPSILON 1e-9
+
+/**
+ * Cost of the implicants of a cover. weights holds the cost of a literal of every variable
+ * by position inside the positional cube representation. Implicants inside shared, sorted,
+ * are used by other outputs too: their AND gate is built once, so their literals only cost
+ * 1 - sharedDiscount of their weight. Shared means prime for more than one output, known before
+ * any cover is chosen, not selected by more than one cover, so the discount approximates the
+ * real sharing
+*/
+typedef struct costModel {
+    int type;
+    int nOfVariables;
+    double* weights;
+    double sharedDiscount;
+    int* shared;
+    int nOfShared;
+} costModel_t;
+
+/**
+ * Returns the cost model with passed name (implicants, literals, gates), -1 if there is none
+*/
+int costModelFromName(char* name);
+
+/**
+ * Returns a cost model of passed type. weights is a comma separated list of the cost of a
+ * literal of every variable, first variable first: missing ones cost 1, NULL means every
+ * literal costs 1
+*/
+costModel_t* createCostModel(int type, char* weights, double sharedDiscount, int nOfVariables);
+
+/**
+ * Sets the implicants shared by more outputs, taking ownership of passed array
+*/
+void setSharedImplicants(costModel_t* model, int* shared, int nOfShared);
+
+/**
+ * Orders implicants by increasing value, for qsort and bsearch
+*/
+int compareImplicants(const void* a, const void* b);
+
+/**
+ * Returns the cost of passed implicant
+*/
+double implicantCost(costModel_t* model, int implicant);
+
+void freeCostModel(costModel_t* model);
+#endif
@@ -156,3 +156,6 @@ int append(int a, int b) {
     return true;
 }
 
+int prepend(int a, int b) {
+    return false;
+}
@@ -88,10 +88,21 @@ bool setDontCare(node_t* this, int value);
 */
 int length(node_t* this);
 
+/**
+ * Frees every element of passed list and sets it to NULL
+*/
+void removeList(node_t** this);
+
 /**
  * function that returns true. Used as criteria to append
  * last element at the end of the list 
 */
 int append(int a, int b);
+
+/**
+ * function that returns false. Used as criteria to insert
+ * an element at the head of the list 
+*/
+int prepend(int a, int b);
 #endif
 
@@ -10,12 +10,16 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <stdbool.h>
+#include <unistd.h>
 #include "linkedlist.h"
 #include "main.h"
+#include "cost.h"
 #include "petrick.h"
-
-static const char variables[] = {'x', 'y', 'z', 'w', 't', 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k'};
-
+#include "outofcore.h"
+#include "writer.h"
+#include "reader.h"
+#include "scheduler.h"
+#include "verify.h"
 
 /**
  * Joins a and b by putting a DC in place of the different digit. 
@@ -38,11 +42,6 @@ int compatible(int, int);
 */
 int criteria(int, int);
 
-/**
- * Print passed implicant using Boolean algebra notation
-*/
-void printImplicantVariables(int, int);
-
 /**
  * Counts number of don't care (00) in n
 */
@@ -53,59 +52,12 @@ int dcCount(int);
 */
 int cardinality(int);
 
-/**
- * Prints a number by replacing every pair of bits with its equivalent in positional cube representation
-*/
-void printPositionalCube(int, int);
-
-/**
- * Function that turns a natural number into his positional cube representation.
- * Every 1 is replaced by 01, every 0 is replaced by 10 and every don't care is
- * replaced by 00.
-*/
-int toPositionalCube(int, int);
-
 /**
  * return the natural representation of passed number given its positional cube representation.
  * Requires n in positional cube representation.
 */
 int fromPositionalCube(int);
 
-void printMatrix(int** m, int row, int col, int n) {
-    bool skip = false;
-    for(int r=0;r<row;r++) {
-        for(int c=0;c<col;c++) {
-            if(r==0 && c==0) {
-                for(int i=0;i<n;i++) 
-                    printf(" ");
-                    printf("\t");
-                continue;
-            }
-            if(c == 0) {
-                if(m[r][c] == -1) {
-                    skip = true;
-                    break;
-                }
-                
-                printPositionalCube(m[r][c],n);
-                printf("\t");
-                continue;
-            }
-
-            if(m[0][c] == -1)
-                continue;
-            
-            if(r == 0) {
-                printf("%d\t",fromPositionalCube(m[r][c]));
-                continue;
-            }
-            printf("%c\t",m[r][c] == 1 ? 'X':' ');
-        }
-        printf(skip?"":"\n");
-        skip = false;
-    }
-}
-
 int cardinality(int n) {
     int card = 0;
     while(n != 0) {
@@ -117,7 +69,7 @@ int cardinality(int n) {
 
 int dcCount(int n) {
     int dc = 0;
-    for(int i=0;i<(sizeof(int)*2);i++) {
+    for(int i=0;i<MAX_VARIABLES;i++) {
         dc += (((~n) & 0b11) == 0b11);
         n >>= 2;
     }
@@ -143,32 +95,6 @@ int compatible(int a, int b) {
     return 1;
 }
 
-void printPositionalCube(int n, int nOfVariables) {
-    if(n < 0) return;
-    int c; 
-    char symbols[] = {'-','1','0',0};
-    int shamt = nOfVariables*2-2;
-    while(nOfVariables-->0) {
-        putchar(symbols[(n & 0b11<<shamt) >> shamt&0b11]);
-        n <<= 2;
-    }
-}
-
-void printImplicantVariables(int n, int nOfVariables) {
-    int var = 0;
-    for(int i = nOfVariables-1;i >= 0; i--) {
-        switch((n>>(2*i)) & 0b11) {
-            case 1:
-                printf("%c",variables[var]);
-                break;
-            case 2:
-                printf("%c'",variables[var]);
-                break;
-        };
-        var++;
-    }
-}
-
 int toPositionalCube(int n, int nOfVariables) {
     int ps = 0;
     int i;
@@ -179,6 +105,21 @@ int toPositionalCube(int n, int nOfVariables) {
     return ps;
 }
 
+void decodeCube(int n, int nOfVariables, int* value, int* dcMask) {
+    *value = 0;
+    *dcMask = 0;
+    for(int i = 0; i < nOfVariables; i++) {
+        switch((n >> (2*i)) & 0b11) {
+            case ONE:
+                *value |= 1 << i;
+                break;
+            case DC:
+                *dcMask |= 1 << i;
+                break;
+        }
+    }
+}
+
 /**
  * Returns b**e
 */
@@ -234,16 +175,6 @@ void removeFromList(node_t** implicants, int (*criteria)(node_t*), int criteriaT
     }
 }
 
-void printList(node_t* l, int n) {
-    while(l != NULL) {
-        printPositionalCube(getData(l), n);
-        printf("\t");
-        printImplicantVariables(getData(l), n);
-        printf("\n");
-        l = next(l);
-    }
-}
-
 /**
  * Executes QuineMcCluskey method given a list of implicants and a number of variables. Passed list is modified to hold 
  * only prime implicants that are made with at least one minterm from the on set
@@ -258,10 +189,12 @@ void executeQMC(node_t** implicants, int nOfVariables) {
         while(nextImplicant != NULL) {
             if (cardinality(getData(cursor) ^ getData(nextImplicant)) == 1 && compatible(getData(cursor), getData(nextImplicant))) {
                 int joinedValue = join(getData(cursor), getData(nextImplicant));
-                if(!contains(*implicants, joinedValue)) 
+                // a cube only covers don't care if both halves do, whichever pair joined it
+                if(!contains(*implicants, joinedValue)) {
                     current = insertNode(implicants, joinedValue, &criteria);
-                if(isDontCare(cursor) && isDontCare(nextImplicant)) 
-                    setDontCare(current, 1);
+                    if(isDontCare(cursor) && isDontCare(nextImplicant)) 
+                        setDontCare(current, 1);
+                }
                 setEssential(cursor, 0);
                 setEssential(nextImplicant, 0);
             }
@@ -302,39 +235,275 @@ void getMintermsFromFile(node_t** minterms, int nOfVariables, char* filename, in
     fclose(fp);
 }
 
+/**
+ * Minimization of a single output, run in two phases: prime implicants of every output
+ * are generated first so that the cover phase knows which of them are shared.
+ * Minterms are loaded before the batch starts so that the cost of the job can be
+ * estimated from them
+*/
+typedef struct job {
+    node_t* constraint;     // ON set minterms
+    node_t* implicants;     // ON and DC set minterms, prime implicants after executeQMC
+    int nOfVariables;
+    size_t memoryBudget;
+    int nOfThreads;         // threads solving the cyclic core of this job
+    bool primesOnly;        // the result is the list of prime implicants, not a cover
+    costModel_t* cost;
+    long nodeLimit;         // nodes the exact cover search of a component may visit
+    uint64_t* on;           // bitmaps of the ON set and of the ON and DC set
+    uint64_t* care;
+    node_t* essentials;
+    verification_t* verification;
+} job_t;
+
+/**
+ * Estimated running time of the primes phase of a job: the in memory method compares
+ * every pair of implicants of adjacent groups, so the cost grows with the square of the
+ * ON and DC set size and with the n. of variables (n. of levels)
+*/
+double primesCost(job_t* job) {
+    double size = length(job->implicants);
+    return size * size * (job->nOfVariables + 1);
+}
+
+/**
+ * Estimated running time of the cover phase of a job: the size of its chart, prime
+ * implicants by ON set minterms
+*/
+double coverCost(job_t* job) {
+    return (double) length(job->implicants) * length(job->constraint);
+}
+
+void runPrimes(void* arg) {
+    job_t* job = (job_t*) arg;
+    job->on = cubesBitmap(job->constraint, job->nOfVariables);
+    job->care = cubesBitmap(job->implicants, job->nOfVariables);
+    if(job->memoryBudget > 0) {
+        node_t* minterms = job->implicants;
+        job->implicants = executeQMCOutOfCore(minterms, job->nOfVariables, job->memoryBudget);
+        removeList(&minterms);
+    } else {
+        executeQMC(&job->implicants, job->nOfVariables);
+    }
+}
+
+void runCover(void* arg) {
+    job_t* job = (job_t*) arg;
+    if(job->primesOnly) {
+        job->essentials = job->implicants;
+        job->implicants = NULL;
+    } else {
+        job->essentials = petrick(job->constraint, job->implicants, job->nOfVariables, job->nOfThreads, job->cost, job->nodeLimit);
+    }
+    job->verification = verifyCover(job->essentials, job->on, job->care, job->nOfVariables);
+    free(job->on);
+    free(job->care);
+    removeList(&job->constraint);
+    removeList(&job->implicants);
+}
+
+/**
+ * Returns the prime implicants of more than one output, their number is stored inside count
+*/
+int* sharedImplicants(job_t* jobs, int nOfOutputs, int* count) {
+    int total = 0, shared = 0;
+    for(int out = 0; out < nOfOutputs; out++)
+        total += length(jobs[out].implicants);
+    int* all = malloc(sizeof(int)*(total > 0 ? total : 1));
+    total = 0;
+    for(int out = 0; out < nOfOutputs; out++) {
+        for(node_t* cursor = jobs[out].implicants; cursor != NULL; cursor = next(cursor))
+            all[total++] = getData(cursor);
+    }
+    // primes of an output are distinct: a repeated one belongs to more outputs
+    qsort(all, total, sizeof(int), compareImplicants);
+    for(int idx = 1; idx < total; idx++) {
+        if(all[idx] == all[idx-1] && (shared == 0 || all[shared-1] != all[idx]))
+            all[shared++] = all[idx];
+    }
+    *count = shared;
+    return all;
+}
+
 int main(int argc, char *argv[]) {
     int nOfVariables = 0;
-    node_t* implicants = NULL; // list of prime implicants 
-    node_t* constraint = NULL; // list of ON set minterms
-    node_t* essentials = NULL; // list of essentials or partial reduntant implicants
-    char* on_filename;
-    char* dc_filename;
-
-    if(argc != 4) {
+    int nOfOutputs = 1;
+    node_t** essentials; // list of essentials or partial reduntant implicants of every output
+    job_t* jobs;
+    task_t* tasks;
+    int nOfThreads = availableThreads();
+    bool verified = true;
+    bool primesOnly = false;
+    int costType = COST_IMPLICANTS;
+    char* weights = NULL;
+    double sharedDiscount = 0;
+    costModel_t* cost;
+    long nodeLimit = DEFAULT_NODE_LIMIT;
+    char* on_filename = NULL;
+    char* dc_filename = NULL;
+    char* names_filename = NULL;
+    size_t memoryBudget = 0; // 0: every level is kept in memory
+    int format = FORMAT_TEXT;
+    int inputFormat = INPUT_MINTERMS;
+    function_t* function = NULL;
+    names_t* names;
+    int opt;
+
+    while((opt = getopt(argc, argv, "m:o:n:i:j:pc:w:d:b:")) != -1) {
+        switch(opt) {
+            case 'p':
+                primesOnly = true;
+                break;
+            case 'c':
+                if((costType = costModelFromName(optarg)) == -1) {
+                    errno = EINVAL;
+                    perror("Cost model must be one of implicants, literals, gates");
+                    exit(1);
+                }
+                break;
+            case 'w':
+                weights = optarg;
+                break;
+            case 'b':
+                if((nodeLimit = atol(optarg)) < 0) {
+                    errno = EINVAL;
+                    perror("Search limit must be at least 0 nodes");
+                    exit(1);
+                }
+                break;
+            case 'd':
+                sharedDiscount = atof(optarg);
+                if(sharedDiscount < 0 || sharedDiscount > 1) {
+                    errno = EINVAL;
+                    perror("Shared implicant discount must be between 0 and 1");
+                    exit(1);
+                }
+                break;
+            case 'j':
+                if((nOfThreads = atoi(optarg)) < 1) {
+                    errno = EINVAL;
+                    perror("Number of threads must be at least 1");
+                    exit(1);
+                }
+                break;
+            case 'i':
+                if((inputFormat = inputFormatFromName(optarg)) == -1) {
+                    errno = EINVAL;
+                    perror("Input format must be one of pla, blif");
+                    exit(1);
+                }
+                break;
+            case 'o':
+                if((format = formatFromName(optarg)) == -1) {
+                    errno = EINVAL;
+                    perror("Output format must be one of text, pla, blif, bin");
+                    exit(1);
+                }
+                break;
+            case 'n':
+                names_filename = optarg;
+                break;
+            case 'm':
+                if(atoi(optarg) < 1) {
+                    errno = EINVAL;
+                    perror("Memory budget must be at least 1 MB");
+                    exit(1);
+                }
+                memoryBudget = (size_t) atoi(optarg) << 20;
+                break;
+            default:
+                exit(1);
+        }
+    }
+    if(argc - optind != (inputFormat == INPUT_MINTERMS ? 3 : 1)) {
         errno = EPERM;
-        perror("Usage: quineMcCluskey on_set_filename dc_set_filename nOfVariables");
+        perror("Usage: quineMcCluskey [-p] [-c implicants|literals|gates] [-w weights] [-d discount] [-b searchNodes] [-m memoryBudgetMB] [-j threads] [-o text|pla|blif|bin] [-n names_filename] on_set_filename dc_set_filename nOfVariables\n"
+               "       quineMcCluskey [-p] [-c implicants|literals|gates] [-w weights] [-d discount] [-b searchNodes] [-m memoryBudgetMB] [-j threads] [-o text|pla|blif|bin] [-n names_filename] -i pla|blif filename");
         exit(1);
+    } else if(inputFormat != INPUT_MINTERMS) {
+        function = inputFormat == INPUT_PLA ? readPLA(argv[optind]) : readBLIF(argv[optind]);
+        nOfVariables = function->nOfVariables;
+        nOfOutputs = function->nOfOutputs;
     } else {
-        on_filename = argv[1];
-        dc_filename = argv[2];
-        nOfVariables = atoi(argv[3]);
+        on_filename = argv[optind];
+        dc_filename = argv[optind+1];
+        nOfVariables = atoi(argv[optind+2]);
         if(nOfVariables > MAX_VARIABLES || nOfVariables < MIN_VARIABLES) {
             errno = EPERM;
             perror("Number of variables must be between 1 and 15 (included)");
             exit(1);
         }
     }
-    getMintermsFromFile(&implicants, nOfVariables, on_filename, 0);
-    getMintermsFromFile(&constraint, nOfVariables, on_filename, 0);
-    getMintermsFromFile(&implicants, nOfVariables, dc_filename, 1);
-    executeQMC(&implicants, nOfVariables);
-    essentials = petrick(constraint, implicants, nOfVariables);
-    printf("Essential implicants:\n");
-    printList(essentials,nOfVariables);
-    printf("\nPoS form:\n");
-    while(essentials != NULL) {
-        printImplicantVariables(getData(essentials), nOfVariables);
-        if((essentials = next(essentials)) != NULL) 
-            printf(nOfVariables<8 ? " + " : " +\n");
+    if(costType == COST_IMPLICANTS && (weights != NULL || sharedDiscount > 0)) {
+        errno = EINVAL;
+        perror("Weights and shared discount need the literals or gates cost");
+        exit(1);
+    }
+    if(sharedDiscount > 0 && nOfOutputs == 1) {
+        errno = EINVAL;
+        perror("Shared discount needs a function with more outputs");
+        exit(1);
+    }
+    cost = createCostModel(costType, weights, sharedDiscount, nOfVariables);
+    jobs = calloc(nOfOutputs, sizeof(job_t));
+    tasks = malloc(sizeof(task_t)*nOfOutputs);
+    for(int out = 0; out < nOfOutputs; out++) {
+        job_t* job = &jobs[out];
+        if(function != NULL) {
+            functionMinterms(function, out, &job->constraint, &job->implicants);
+        } else {
+            getMintermsFromFile(&job->constraint, nOfVariables, on_filename, 0);
+            getMintermsFromFile(&job->implicants, nOfVariables, on_filename, 0);
+            getMintermsFromFile(&job->implicants, nOfVariables, dc_filename, 1);
+        }
+        job->nOfVariables = nOfVariables;
+        job->memoryBudget = memoryBudget;
+        job->primesOnly = primesOnly;
+        job->cost = cost;
+        job->nodeLimit = nodeLimit;
+        tasks[out].run = runPrimes;
+        tasks[out].arg = job;
+        tasks[out].cost = primesCost(job);
+        // every job may split its cyclic core between the threads left idle by the others
+        job->nOfThreads = nOfThreads;
+    }
+    setThreadLimit(nOfThreads);
+    runTasks(tasks, nOfOutputs, nOfThreads);
+    if(sharedDiscount > 0) {
+        int nOfShared;
+        int* shared = sharedImplicants(jobs, nOfOutputs, &nOfShared);
+        setSharedImplicants(cost, shared, nOfShared);
     }
-}
\ No newline at end of file
+    for(int out = 0; out < nOfOutputs; out++) {
+        tasks[out].run = runCover;
+        tasks[out].cost = coverCost(&jobs[out]);
+    }
+    runTasks(tasks, nOfOutputs, nOfThreads);
+    if(names_filename != NULL || function == NULL)
+        names = readNames(names_filename, nOfVariables, nOfOutputs);
+    else
+        names = function->names;
+    essentials = malloc(sizeof(node_t*)*nOfOutputs);
+    for(int out = 0; out < nOfOutputs; out++) {
+        essentials[out] = jobs[out].essentials;
+        if(jobs[out].verification->errors > 0) {
+            reportVerification(stderr, jobs[out].verification, names->outputs[out]);
+            verified = false;
+        }
+        freeVerification(jobs[out].verification);
+    }
+    if(!verified)
+        exit(1);
+    writeCovers(stdout, format, essentials, nOfOutputs, nOfVariables, names);
+
+    for(int out = 0; out < nOfOutputs; out++)
+        removeList(&essentials[out]);
+    if(function == NULL || names != function->names)
+        freeNames(names);
+    if(function != NULL)
+        freeFunction(function);
+    freeCostModel(cost);
+    free(essentials);
+    free(jobs);
+    free(tasks);
+}
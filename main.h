@@ -13,11 +13,15 @@
 int literals(int n);
 
 /**
- * Prints passed matrix.
- * @param m pointer to matrix
- * @param row number of rows 
- * @param col number of columns
- * @param n number of variables considered 
+ * Function that turns a natural number into his positional cube representation.
+ * Every 1 is replaced by 01, every 0 is replaced by 10 and every don't care is
+ * replaced by 00.
 */
-void printMatrix(int** m, int row, int col, int n);
+int toPositionalCube(int n, int nOfVariables);
+
+/**
+ * Splits n, in positional cube representation, in the natural value of its literals
+ * and the mask of its don't care positions
+*/
+void decodeCube(int n, int nOfVariables, int* value, int* dcMask);
 #endif
\ No newline at end of file
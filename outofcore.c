@@ -0,0 +1,274 @@
+/**
+ * OUT OF CORE QUINE MCCLUSKEY
+ * Executes the Quine McCluskey method one combination level at a time: level k holds the
+ * implicants with k don't care and lives inside a spill file sorted by dc mask, so that
+ * implicants that can be joined are next to each other. Only one group of implicants with
+ * the same dc mask and the buffers of the next level and of the primes, at most memoryBudget
+ * bytes together, are kept in memory. The group itself, its slot and joined arrays (2^n
+ * entries each) and the list of minterms of level 0 are outside the budget
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "linkedlist.h"
+#include "main.h"
+#include "outofcore.h"
+
+#define MAX_RUNS 256
+
+typedef struct cube {
+    int data;
+    int dontCare;
+    int mask;       // dcMask(data), kept so that sorting doesn't recompute it
+} cube_t;
+
+/**
+ * Returns the mask of the don't care pairs of n. Unused variables count as don't care
+ * for every cube, so they don't change the grouping
+*/
+int dcMask(int n) {
+    int mask = ~(n | (n >> 1)) & 0x15555555; // low bit of every 00 pair of the 15 variables
+    return mask | (mask << 1);
+}
+
+/**
+ * Returns the natural value of the positive literals of n
+*/
+int cubeValue(int n) {
+    int value = 0;
+    for(int i = 0; i < MAX_VARIABLES; i++) {
+        if(((n >> (2*i)) & 0b11) == ONE)
+            value |= 1 << i;
+    }
+    return value;
+}
+
+/**
+ * Orders cubes by dc mask first and by value then
+*/
+int compareCubes(const void* a, const void* b) {
+    const cube_t* ca = (const cube_t*) a;
+    const cube_t* cb = (const cube_t*) b;
+    if(ca->mask != cb->mask) return ca->mask < cb->mask ? -1 : 1;
+    if(ca->data != cb->data) return ca->data < cb->data ? -1 : 1;
+    return 0;
+}
+
+FILE* spillFile() {
+    FILE* fp = tmpfile();
+    if(fp == NULL) {
+        perror("Error while creating spill file");
+        exit(1);
+    }
+    return fp;
+}
+
+void writeCubes(FILE* fp, cube_t* cubes, size_t count) {
+    if(fwrite(cubes, sizeof(cube_t), count, fp) != count) {
+        perror("Error while writing spill file");
+        exit(1);
+    }
+}
+
+/**
+ * Set of sorted runs of the next level. Cubes are collected inside buffer and
+ * written as a new sorted run whenever the buffer is full. The tier of a run is the
+ * n. of merge passes its cubes went through
+*/
+typedef struct runs {
+    cube_t* buffer;
+    size_t size;
+    size_t capacity;
+    FILE** files;
+    int* tiers;
+    int count;
+} runs_t;
+
+/**
+ * Merges count sorted files into a single sorted file without duplicates, closes them and
+ * returns the number of cubes written. A cube obtained from at least a pair with an ON
+ * minterm isn't a don't care
+*/
+long mergeFiles(FILE** files, int count, FILE* out) {
+    cube_t* heads = malloc(sizeof(cube_t)*(count > 0 ? count : 1));
+    bool* alive = malloc(sizeof(bool)*(count > 0 ? count : 1));
+    cube_t last;
+    long written = 0;
+    bool pending = false;
+
+    for(int idx = 0; idx < count; idx++) {
+        rewind(files[idx]);
+        alive[idx] = fread(&heads[idx], sizeof(cube_t), 1, files[idx]) == 1;
+    }
+    while(true) {
+        int min = -1;
+        for(int idx = 0; idx < count; idx++) {
+            if(alive[idx] && (min == -1 || compareCubes(&heads[idx], &heads[min]) < 0))
+                min = idx;
+        }
+        if(min == -1) break;
+        if(pending && last.data == heads[min].data) {
+            last.dontCare &= heads[min].dontCare;
+        } else {
+            if(pending) {
+                writeCubes(out, &last, 1);
+                written++;
+            }
+            last = heads[min];
+            pending = true;
+        }
+        alive[min] = fread(&heads[min], sizeof(cube_t), 1, files[min]) == 1;
+    }
+    if(pending) {
+        writeCubes(out, &last, 1);
+        written++;
+    }
+    for(int idx = 0; idx < count; idx++)
+        fclose(files[idx]);
+    free(heads);
+    free(alive);
+    return written;
+}
+
+/**
+ * Merges all runs into out and returns the number of cubes written
+*/
+long mergeRuns(runs_t* runs, FILE* out) {
+    long written = mergeFiles(runs->files, runs->count, out);
+    free(runs->files);
+    free(runs->tiers);
+    runs->files = NULL;
+    runs->tiers = NULL;
+    runs->count = 0;
+    return written;
+}
+
+/**
+ * Writes the buffer as a new sorted run of tier 0. Whenever the last MAX_RUNS runs have the
+ * same tier they are merged into a single run of the next tier, so every cube is copied
+ * once per tier instead of once per merge and tiers decrease along the runs
+*/
+void flushRun(runs_t* runs) {
+    if(runs->size == 0) return;
+    qsort(runs->buffer, runs->size, sizeof(cube_t), compareCubes);
+    runs->files = realloc(runs->files, sizeof(FILE*)*(runs->count+1));
+    runs->tiers = realloc(runs->tiers, sizeof(int)*(runs->count+1));
+    runs->files[runs->count] = spillFile();
+    runs->tiers[runs->count] = 0;
+    writeCubes(runs->files[runs->count++], runs->buffer, runs->size);
+    runs->size = 0;
+    while(runs->count >= MAX_RUNS && runs->tiers[runs->count-MAX_RUNS] == runs->tiers[runs->count-1]) {
+        int first = runs->count - MAX_RUNS;
+        FILE* merged = spillFile();
+        mergeFiles(runs->files + first, MAX_RUNS, merged);
+        runs->files[first] = merged;
+        runs->tiers[first]++;
+        runs->count = first + 1;
+    }
+}
+
+void addToRun(runs_t* runs, int data, int dontCare) {
+    if(runs->size == runs->capacity)
+        flushRun(runs);
+    runs->buffer[runs->size].data = data;
+    runs->buffer[runs->size].dontCare = dontCare;
+    runs->buffer[runs->size++].mask = dcMask(data);
+}
+
+/**
+ * Joins every pair of cubes of group differing in a single literal. Joined cubes go to the
+ * runs of the next level, cubes that can't be joined are prime and go to the runs of primes
+ * unless they only cover don't care. Cubes of a group share their dc mask, so slot can map the value of
+ * a cube to its index + 1 inside the group
+*/
+void joinGroup(cube_t* group, int size, int* slot, bool* joined, runs_t* runs, runs_t* primes, int nOfVariables) {
+    for(int idx = 0; idx < size; idx++) {
+        slot[cubeValue(group[idx].data)] = idx + 1;
+        joined[idx] = false;
+    }
+    for(int idx = 0; idx < size; idx++) {
+        int a = group[idx].data;
+        for(int i = 0; i < nOfVariables; i++) {
+            if(((a >> (2*i)) & 0b11) != ONE)
+                continue;
+            int other = slot[cubeValue(a) & ~(1 << i)];
+            if(other == 0)
+                continue;
+            addToRun(runs, a & ~(0b11 << (2*i)), group[idx].dontCare && group[other-1].dontCare);
+            joined[idx] = joined[other-1] = true;
+        }
+    }
+    for(int idx = 0; idx < size; idx++) {
+        slot[cubeValue(group[idx].data)] = 0;
+        if(!joined[idx] && !group[idx].dontCare)
+            addToRun(primes, group[idx].data, group[idx].dontCare);
+    }
+}
+
+node_t* executeQMCOutOfCore(node_t* minterms, int nOfVariables, size_t memoryBudget) {
+    int groupCapacity = 1 << nOfVariables; // a group holds at most 2^(n-k) cubes
+    int* slot = calloc(groupCapacity, sizeof(int));
+    cube_t* group = malloc(sizeof(cube_t)*groupCapacity);
+    bool* joined = malloc(sizeof(bool)*groupCapacity);
+    FILE* level = spillFile();
+    FILE* sorted;
+    node_t* implicants = NULL;
+    runs_t runs, primes;
+    long levelSize = 0;
+    cube_t current;
+
+    // the budget is split between the next level and the primes
+    runs.capacity = memoryBudget / 2 / sizeof(cube_t) > 0 ? memoryBudget / 2 / sizeof(cube_t) : 1;
+    runs.buffer = malloc(sizeof(cube_t)*runs.capacity);
+    runs.size = 0;
+    runs.files = NULL;
+    runs.tiers = NULL;
+    runs.count = 0;
+    primes = runs;
+    primes.buffer = malloc(sizeof(cube_t)*primes.capacity);
+
+    // level 0: minterms
+    for(node_t* cursor = minterms; cursor != NULL; cursor = next(cursor))
+        addToRun(&runs, getData(cursor), isDontCare(cursor));
+    flushRun(&runs);
+    levelSize = mergeRuns(&runs, level);
+
+    while(levelSize > 0) {
+        int size = 0;
+        rewind(level);
+        while(fread(&current, sizeof(cube_t), 1, level) == 1) {
+            if(size > 0 && current.mask != group[0].mask) {
+                joinGroup(group, size, slot, joined, &runs, &primes, nOfVariables);
+                size = 0;
+            }
+            group[size++] = current;
+        }
+        if(size > 0)
+            joinGroup(group, size, slot, joined, &runs, &primes, nOfVariables);
+        flushRun(&runs);
+        fclose(level);
+        level = spillFile();
+        levelSize = mergeRuns(&runs, level);
+    }
+    fclose(level);
+
+    // primes are merged like a level, sorted by dc mask: prepending them reverses the order
+    flushRun(&primes);
+    sorted = spillFile();
+    mergeRuns(&primes, sorted);
+    rewind(sorted);
+    while(fread(&current, sizeof(cube_t), 1, sorted) == 1) {
+        if(insertNode(&implicants, current.data, prepend) == NULL) {
+            perror("Error while adding implicants\n");
+            exit(1);
+        }
+    }
+    fclose(sorted);
+    free(runs.buffer);
+    free(primes.buffer);
+    free(slot);
+    free(group);
+    free(joined);
+    return implicants;
+}
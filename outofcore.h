@@ -0,0 +1,15 @@
+#ifndef _OUT_OF_CORE
+#define _OUT_OF_CORE
+#include <stddef.h>
+
+/**
+ * Executes QuineMcCluskey method one combination level at a time, keeping every level and
+ * the prime implicants found so far inside spill files. Returns the list of prime implicants
+ * that are made with at least one minterm from the on set
+ * @param minterms list of ON and DC set minterms, DC ones marked as don't care
+ * @param nOfVariables number of considered variables (up to 15)
+ * @param memoryBudget bytes of the buffers collecting the next level and the prime implicants
+ *        before they're spilled; the 2^nOfVariables entries group arrays and minterms aren't counted
+*/
+node_t* executeQMCOutOfCore(node_t* minterms, int nOfVariables, size_t memoryBudget);
+#endif
\ No newline at end of file
@@ -8,247 +8,638 @@
 #include <stdbool.h>
 #include "linkedlist.h"
 #include "main.h"
+#include "chart.h"
+#include "scheduler.h"
+#include "cost.h"
 #include "petrick.h"
 
 /**
- * Removes every row that doesn't cover any constraint and
- * returns the number of removed lines
+ * FIFO of row or column indexes waiting to be examined. Every index is queued at most
+ * once at a time so the queue never holds more than size elements
 */
-int removeEmptyImplicants(chart_t** implicantsChart) {
-    int rowsRemoved = 0;
-    int cols = (*implicantsChart)->columns;
-    int rows = (*implicantsChart)->rows;
-    int uncoveredCostraint = 0;
+typedef struct worklist {
+    int* items;
+    bool* queued;
+    int size;
+    int head;
+    int count;
+} worklist_t;
 
-    for(int row = 1; row < rows; row++) {
-        for(int col = 1; col <cols;col++) {
-            if((*implicantsChart)->matrix[row][col]) {
-                uncoveredCostraint++;
-                if((*implicantsChart)->matrix[0][col] == -1)
-                    uncoveredCostraint--;
-            }
+worklist_t* createWorklist(int size) {
+    worklist_t* list = malloc(sizeof(worklist_t));
+    list->items = malloc(sizeof(int)*size);
+    list->queued = calloc(size, sizeof(bool));
+    list->size = size;
+    list->head = 0;
+    list->count = 0;
+    return list;
+}
+
+void freeWorklist(worklist_t* list) {
+    free(list->items);
+    free(list->queued);
+    free(list);
+}
+
+/**
+ * Queues idx if it isn't already waiting inside the list
+*/
+void push(worklist_t* list, int idx) {
+    if(list->queued[idx]) return;
+    list->queued[idx] = true;
+    list->items[(list->head + list->count++) % list->size] = idx;
+}
+
+/**
+ * Returns the oldest queued index, -1 if the list is empty
+*/
+int pop(worklist_t* list) {
+    if(list->count == 0) return -1;
+    int idx = list->items[list->head];
+    list->head = (list->head + 1) % list->size;
+    list->count--;
+    list->queued[idx] = false;
+    return idx;
+}
+
+/**
+ * State of the chart reduction: changed rows and columns waiting to be examined and
+ * scratch buffers for the active cells of a row and of a column
+*/
+typedef struct reduction {
+    chart_t* chart;
+    worklist_t* dirtyRows;
+    worklist_t* dirtyCols;
+    node_t** essentials;
+    costModel_t* cost;
+    int* rowBuffer;
+    int* colBuffer;
+} reduction_t;
+
+/**
+ * Removes passed row from the chart: every constraint it covered loses a cover
+ * and has to be examined again
+*/
+void removeRow(reduction_t* r, int row) {
+    int count = rowColumns(r->chart, row, r->colBuffer);
+    deactivateRow(r->chart, row);
+    for(int idx = 0; idx < count; idx++) {
+        r->chart->colCount[r->colBuffer[idx]]--;
+        push(r->dirtyCols, r->colBuffer[idx]);
+    }
+}
+
+/**
+ * Removes passed column from the chart: every implicant that covered it loses a
+ * constraint and has to be examined again
+*/
+void removeColumn(reduction_t* r, int col) {
+    int count = columnRows(r->chart, col, r->rowBuffer);
+    deactivateColumn(r->chart, col);
+    for(int idx = 0; idx < count; idx++) {
+        r->chart->rowCount[r->rowBuffer[idx]]--;
+        push(r->dirtyRows, r->rowBuffer[idx]);
+    }
+}
+
+/**
+ * Examines a changed column: if a single implicant covers it that implicant is essential,
+ * otherwise every column that contains it is dominated and gets removed.
+ * Only columns sharing the implicant with fewest constraints can contain col
+*/
+void checkColumn(reduction_t* r, int col) {
+    chart_t* implicantsChart = r->chart;
+    int pivot = -1, count;
+
+    if(implicantsChart->colCount[col] == 0) { // nothing left to cover it with
+        removeColumn(r, col);
+        return;
+    }
+    count = columnRows(implicantsChart, col, r->rowBuffer);
+    for(int idx = 0; idx < count; idx++) {
+        int row = r->rowBuffer[idx];
+        if(pivot == -1 || implicantsChart->rowCount[row] < implicantsChart->rowCount[pivot])
+            pivot = row;
+    }
+    count = rowColumns(implicantsChart, pivot, r->colBuffer);
+    if(implicantsChart->colCount[col] == 1) { // is essential
+        insertNode(r->essentials, implicantsChart->implicants[pivot], append);
+        for(int idx = 0; idx < count; idx++)
+            removeColumn(r, r->colBuffer[idx]);
+        removeRow(r, pivot);
+        return;
+    }
+    for(int idx = 0; idx < count; idx++) {
+        int col2 = r->colBuffer[idx];
+        if(col2 != col && implicantsChart->constraints[col2] != -1 && columnSubset(implicantsChart, col, col2))
+            removeColumn(r, col2);
+    }
+}
+
+/**
+ * Returns true if the implicant of row is better than the one of row2: it costs less,
+ * or it costs the same and has fewer literals, or it's equal and comes first
+*/
+bool preferredRow(reduction_t* r, int row, int row2) {
+    double cost1 = implicantCost(r->cost, r->chart->implicants[row]);
+    double cost2 = implicantCost(r->cost, r->chart->implicants[row2]);
+    if(cost1 < cost2 - COST_EPSILON || cost1 > cost2 + COST_EPSILON)
+        return cost1 < cost2;
+    int literals1 = literals(r->chart->implicants[row]);
+    int literals2 = literals(r->chart->implicants[row2]);
+    return literals1 < literals2 || (literals1 == literals2 && row < row2);
+}
+
+/**
+ * Examines a changed row: it is removed if it doesn't cover any constraint or if another
+ * implicant that costs no more covers all of its constraints. Equal rows are decided by
+ * preferredRow. Only rows sharing the constraint with fewest implicants can contain row
+*/
+void checkRow(reduction_t* r, int row) {
+    chart_t* implicantsChart = r->chart;
+    int pivot = -1, count;
+
+    if(implicantsChart->rowCount[row] == 0) {
+        removeRow(r, row);
+        return;
+    }
+    count = rowColumns(implicantsChart, row, r->colBuffer);
+    for(int idx = 0; idx < count; idx++) {
+        int col = r->colBuffer[idx];
+        if(pivot == -1 || implicantsChart->colCount[col] < implicantsChart->colCount[pivot])
+            pivot = col;
+    }
+    count = columnRows(implicantsChart, pivot, r->rowBuffer);
+    for(int idx = 0; idx < count; idx++) {
+        int row2 = r->rowBuffer[idx];
+        if(row2 == row || implicantsChart->implicants[row2] == -1 || !rowSubset(implicantsChart, row, row2))
+            continue;
+        if(implicantsChart->rowCount[row] == implicantsChart->rowCount[row2] && preferredRow(r, row, row2)) {
+            removeRow(r, row2);
+            continue;
         }
-        if(uncoveredCostraint == 0) {
-            (*implicantsChart)->matrix[row][0] = -1;
-            rowsRemoved++;
+        if(implicantCost(r->cost, implicantsChart->implicants[row2]) <= implicantCost(r->cost, implicantsChart->implicants[row]) + COST_EPSILON) {
+            removeRow(r, row);
+            return;
         }
     }
-    return rowsRemoved;
 }
 
 /**
- * Finds all essential implicants, adds them to the essential list and 
- * returns the number of covered constraints
+ * Applies essential implicants, row dominance and column dominance until none of them
+ * simplifies the chart any further. Removing a row or a column only queues its
+ * neighbours, so the work done is proportional to the number of changes.
+ * Returns the number of constraints left uncovered (cyclic core)
 */
-int findEssentials(chart_t** implicantsChart, node_t** essentials) {
-    int constrainstCovered = 0;
-    bool count;
-    int cols = (*implicantsChart)->columns;
-    int rows = (*implicantsChart)->rows;
-    int implicantRow = 0;
+int reduceChart(chart_t* implicantsChart, node_t** essentials, costModel_t* cost) {
+    reduction_t r;
+    int idx, left = 0;
 
-    for(int col = 1; col < cols; col++) {
-        if((*implicantsChart)->matrix[0][col] == -1) 
+    r.chart = implicantsChart;
+    r.dirtyRows = createWorklist(implicantsChart->rows + 1);
+    r.dirtyCols = createWorklist(implicantsChart->columns + 1);
+    r.essentials = essentials;
+    r.cost = cost;
+    r.rowBuffer = malloc(sizeof(int)*(implicantsChart->rows + 1));
+    r.colBuffer = malloc(sizeof(int)*(implicantsChart->columns + 1));
+    for(int col = 0; col < implicantsChart->columns; col++)
+        push(r.dirtyCols, col);
+    for(int row = 0; row < implicantsChart->rows; row++)
+        push(r.dirtyRows, row);
+    while(r.dirtyRows->count > 0 || r.dirtyCols->count > 0) {
+        if((idx = pop(r.dirtyCols)) != -1) {
+            if(implicantsChart->constraints[idx] != -1)
+                checkColumn(&r, idx);
             continue;
-        count = false;
-        implicantRow = 0;
-        for(int row = 1; row < rows; row++) {
-            if((*implicantsChart)->matrix[row][0] == -1) 
-                continue;
-            if((*implicantsChart)->matrix[row][col]) {
-                implicantRow = row;
-                count = !count;
-                if(!count) break;
-            }
-        }
-        if(count) { // is essential
-            insertNode(essentials, (*implicantsChart)->matrix[implicantRow][0],append);
-            (*implicantsChart)->matrix[implicantRow][0] = -1;
-            for(int col2=1;col2<cols;col2++) {
-                if((*implicantsChart)->matrix[implicantRow][col2]) {
-                    constrainstCovered++;
-                    (*implicantsChart)->matrix[0][col2] = -1;
-                }
-            }
-            
         }
+        idx = pop(r.dirtyRows);
+        if(implicantsChart->implicants[idx] != -1)
+            checkRow(&r, idx);
     }
-    return constrainstCovered;
+    freeWorklist(r.dirtyRows);
+    freeWorklist(r.dirtyCols);
+    free(r.rowBuffer);
+    free(r.colBuffer);
+    for(int col = 0; col < implicantsChart->columns; col++)
+        left += implicantsChart->constraints[col] != -1;
+    return left;
 }
 
 /**
- * Removes every dominated row and returns how many implicants it removed
+ * Returns the representative of passed element, compressing the path to it
 */
-int rowDominance(chart_t** implicantsChart, node_t** essentials) {
-    int rowsRemoved = 0;
-    bool count;
-    int cols = (*implicantsChart)->columns;
-    int rows = (*implicantsChart)->rows;
+int findSet(int* parent, int idx) {
+    while(parent[idx] != idx) {
+        parent[idx] = parent[parent[idx]];
+        idx = parent[idx];
+    }
+    return idx;
+}
+
+/**
+ * Splits the active part of the chart into the connected components of the bipartite
+ * graph between implicants and constraints: components share no row and no column, so
+ * each of them can be covered on its own. Components are returned ordered by their first
+ * constraint and their number is stored inside count
+*/
+component_t* findComponents(chart_t* implicantsChart, int* count, costModel_t* cost) {
+    int rows = implicantsChart->rows;
+    int cols = implicantsChart->columns;
+    int* parent = malloc(sizeof(int)*(rows+cols));
+    int* componentOf = malloc(sizeof(int)*(rows+cols));
+    int* buffer = malloc(sizeof(int)*(cols+1));
+    component_t* components;
+    int found = 0, size;
 
-    for(int row = 1; row < rows - 1; row++) {
-        if((*implicantsChart)->matrix[row][0] == -1) 
+    for(int idx = 0; idx < rows+cols; idx++) {
+        parent[idx] = idx;
+        componentOf[idx] = -1;
+    }
+    for(int row = 0; row < rows; row++) {
+        if(implicantsChart->implicants[row] == -1)
             continue;
-        for(int row2 = row + 1; row2 < rows; row2++) {
-            int relativeCardinality[] = {0,0};
-            if((*implicantsChart)->matrix[row2][0] == -1) 
-                continue;
-            for(int col = 1;col<cols;col++) {
-                if((*implicantsChart)->matrix[0][col] == -1) 
-                    continue;
-                int rowContent1 = (*implicantsChart)->matrix[row][col];
-                int rowContent2 = (*implicantsChart)->matrix[row2][col];
-                if(rowContent1 ^ rowContent2)
-                    relativeCardinality[rowContent1 < rowContent2]++;
-            }
+        size = rowColumns(implicantsChart, row, buffer);
+        for(int idx = 0; idx < size; idx++)
+            parent[findSet(parent, row)] = findSet(parent, rows+buffer[idx]);
+    }
+    for(int col = 0; col < cols; col++) {
+        if(implicantsChart->constraints[col] == -1)
+            continue;
+        int root = findSet(parent, rows+col);
+        if(componentOf[root] == -1)
+            componentOf[root] = found++;
+    }
+    components = calloc(found > 0 ? found : 1, sizeof(component_t));
+    // first pass: size of every component, so that each one only allocates its own rows and columns
+    for(int col = 0; col < cols; col++) {
+        if(implicantsChart->constraints[col] != -1)
+            components[componentOf[findSet(parent, rows+col)]].columns++;
+    }
+    for(int row = 0; row < rows; row++) {
+        if(implicantsChart->implicants[row] != -1 && implicantsChart->rowCount[row] > 0)
+            components[componentOf[findSet(parent, row)]].rows++;
+    }
+    for(int idx = 0; idx < found; idx++) {
+        int componentRows = components[idx].rows > 0 ? components[idx].rows : 1;
+        int componentCols = components[idx].columns;
+        components[idx].implicants = malloc(sizeof(int)*componentRows);
+        components[idx].rowCost = malloc(sizeof(double)*componentRows);
+        components[idx].rowCols = malloc(sizeof(int*)*componentRows);
+        components[idx].rowSize = calloc(componentRows, sizeof(int));
+        components[idx].colRows = malloc(sizeof(int*)*componentCols);
+        components[idx].colSize = calloc(componentCols, sizeof(int));
+        components[idx].rows = 0;
+        components[idx].columns = 0;
+    }
+    // local indexes: rows and columns are numbered in chart order inside their component
+    int* local = malloc(sizeof(int)*cols);
+    for(int col = 0; col < cols; col++) {
+        if(implicantsChart->constraints[col] == -1)
+            continue;
+        component_t* component = &components[componentOf[findSet(parent, rows+col)]];
+        local[col] = component->columns;
+        component->colRows[component->columns++] = malloc(sizeof(int)*implicantsChart->colCount[col]);
+    }
+    for(int row = 0; row < rows; row++) {
+        if(implicantsChart->implicants[row] == -1 || implicantsChart->rowCount[row] == 0)
+            continue;
+        component_t* component = &components[componentOf[findSet(parent, row)]];
+        int localRow = component->rows++;
+        component->implicants[localRow] = implicantsChart->implicants[row];
+        component->rowCost[localRow] = implicantCost(cost, implicantsChart->implicants[row]);
+        component->rowCols[localRow] = malloc(sizeof(int)*implicantsChart->rowCount[row]);
+        size = rowColumns(implicantsChart, row, buffer);
+        for(int idx = 0; idx < size; idx++) {
+            int localCol = local[buffer[idx]];
+            component->rowCols[localRow][component->rowSize[localRow]++] = localCol;
+            component->colRows[localCol][component->colSize[localCol]++] = localRow;
+        }
+    }
+    free(local);
+    free(buffer);
+    free(parent);
+    free(componentOf);
+    *count = found;
+    return components;
+}
 
-            switch (!!relativeCardinality[0] + !!relativeCardinality[1]) {
-            case 0: // equal rows: depends on n. of literals
-                if(literals((*implicantsChart)->matrix[row][0]) <= literals((*implicantsChart)->matrix[row2][0]))
-                    (*implicantsChart)->matrix[row2][0] = -1;
-                else
-                    (*implicantsChart)->matrix[row][0] = -1;
-                rowsRemoved++;
-                break;
-            case 1: // dominance
-                if(!!relativeCardinality[0])
-                    (*implicantsChart)->matrix[row2][0] = -1;
-                else
-                    (*implicantsChart)->matrix[row][0] = -1;
-                rowsRemoved++;
-                break;
-            default:
-                break;
-            }
+/**
+ * State of the branch and bound search over a single component
+*/
+typedef struct search {
+    component_t* component;
+    int* coverCount;    // selected rows covering every column
+    int* available;     // rows not excluded by previous branches covering every column
+    bool* excluded;     // rows that earlier sibling branches already tried
+    int* selected;      // rows currently selected
+    int* gain;          // uncovered columns of every row
+    int* order;         // uncovered columns sorted by available rows
+    int* mark;          // row stamps
+    int* colMark;       // column stamps
+    int stamp;
+    long nodes;         // nodes visited so far
+} search_t;
+
+/**
+ * Selects (delta = 1) or deselects (delta = -1) row and returns how many
+ * columns changed their covered state
+*/
+int toggleRow(search_t* s, int row, int delta) {
+    int changed = 0;
+    for(int idx = 0; idx < s->component->rowSize[row]; idx++) {
+        int col = s->component->rowCols[row][idx];
+        s->coverCount[col] += delta;
+        changed += (delta > 0) ? s->coverCount[col] == 1 : s->coverCount[col] == 0;
+    }
+    return changed;
+}
+
+/**
+ * Excludes (delta = -1) or readmits (delta = 1) row from the rows the search can select
+*/
+void excludeRow(search_t* s, int row, int delta) {
+    s->excluded[row] = delta < 0;
+    for(int idx = 0; idx < s->component->rowSize[row]; idx++)
+        s->available[s->component->rowCols[row][idx]] += delta;
+}
+
+/**
+ * Returns a lower bound on the cost still needed: uncovered columns that share no
+ * available row need a distinct row each, at least the cheapest available one.
+ * Columns with fewer available rows are tried first. Returns -1 if a column can't
+ * be covered anymore
+*/
+double lowerBound(search_t* s) {
+    component_t* component = s->component;
+    double bound = 0;
+    int count = 0;
+
+    s->stamp++;
+    for(int col = 0; col < component->columns; col++) {
+        if(s->coverCount[col] > 0)
+            continue;
+        if(s->available[col] == 0)
+            return -1;
+        int pos = count++;
+        while(pos > 0 && s->available[s->order[pos-1]] > s->available[col]) {
+            s->order[pos] = s->order[pos-1];
+            pos--;
+        }
+        s->order[pos] = col;
+    }
+    for(int idx = 0; idx < count; idx++) {
+        int col = s->order[idx];
+        bool independent = true;
+        for(int r = 0; r < component->colSize[col] && independent; r++) {
+            int row = component->colRows[col][r];
+            independent = s->excluded[row] || s->mark[row] != s->stamp;
         }
+        if(!independent)
+            continue;
+        double cheapest = -1;
+        for(int r = 0; r < component->colSize[col]; r++) {
+            int row = component->colRows[col][r];
+            s->mark[row] = s->stamp;
+            if(!s->excluded[row] && (cheapest < 0 || component->rowCost[row] < cheapest))
+                cheapest = component->rowCost[row];
+        }
+        bound += cheapest;
     }
-    return rowsRemoved;
+    return bound;
 }
 
 /**
- * Removes every dominated column and returns how many constraint it removed
+ * Excludes every available row whose uncovered columns are all covered by another
+ * available row that costs no more (the first one wins among equal rows of equal cost).
+ * Excluded rows are appended to removed and their number is returned
 */
-int colDominance(chart_t** implicantsChart, node_t** essentials) {
-    int colsRemoved = 0;
-    bool count;
-    int cols = (*implicantsChart)->columns;
-    int rows = (*implicantsChart)->rows;
+int excludeDominated(search_t* s, int* removed) {
+    component_t* component = s->component;
+    int count = 0;
 
-    for(int col = 1; col < cols - 1; col++) {
-        if((*implicantsChart)->matrix[0][col] == -1) 
+    for(int row = 0; row < component->rows; row++) {
+        s->gain[row] = 0;
+        if(s->excluded[row])
+            continue;
+        for(int idx = 0; idx < component->rowSize[row]; idx++)
+            s->gain[row] += s->coverCount[component->rowCols[row][idx]] == 0;
+        if(s->gain[row] == 0) {
+            excludeRow(s, row, -1);
+            removed[count++] = row;
+        }
+    }
+    for(int row = 0; row < component->rows; row++) {
+        if(s->excluded[row])
             continue;
-        for(int col2 = col + 1; col2 < cols; col2++) {
-            int relativeCardinality[] = {0,0};
-            if((*implicantsChart)->matrix[0][col2] == -1) 
+        s->stamp++;
+        for(int idx = 0; idx < component->rowSize[row]; idx++)
+            s->colMark[component->rowCols[row][idx]] = s->stamp;
+        for(int row2 = 0; row2 < component->rows; row2++) {
+            double cost = component->rowCost[row], cost2 = component->rowCost[row2];
+            if(row2 == row || s->excluded[row2] || s->gain[row2] < s->gain[row] || cost2 > cost + COST_EPSILON)
+                continue;
+            if(s->gain[row2] == s->gain[row] && cost2 >= cost - COST_EPSILON && row2 > row)
                 continue;
-            for(int row = 1;row<rows;row++) {
-                if((*implicantsChart)->matrix[row][0] == -1) 
-                    continue;
-                int colContent1 = (*implicantsChart)->matrix[row][col];
-                int colContent2 = (*implicantsChart)->matrix[row][col2];
-                if(colContent1 ^ colContent2)
-                    relativeCardinality[colContent1 < colContent2]++;
+            int shared = 0;
+            for(int idx = 0; idx < component->rowSize[row2]; idx++) {
+                int col = component->rowCols[row2][idx];
+                shared += s->coverCount[col] == 0 && s->colMark[col] == s->stamp;
             }
-
-            switch (!!relativeCardinality[0] + !!relativeCardinality[1]) {
-            case 0: // equal rows: depends on n. of literals
-                (*implicantsChart)->matrix[0][col2] = -1;
-                colsRemoved++;
-                break;
-            case 1: // dominance
-                if(!!relativeCardinality[0])
-                    (*implicantsChart)->matrix[0][col] = -1;
-                else
-                    (*implicantsChart)->matrix[0][col2] = -1;
-                    colsRemoved++;
-                break;
-            default:
+            if(shared == s->gain[row]) {
+                excludeRow(s, row, -1);
+                removed[count++] = row;
                 break;
             }
         }
     }
-    return colsRemoved;
+    return count;
 }
 
 /**
- * Returns true if implicant covers the constraint e.g. every non
- * dc digit is equal, false otherwise.
- * Requires implicant and constraint in positional cube representation
+ * Returns true if a row covering gainA uncovered constraints at costA is a more
+ * promising branch than one covering gainB at costB: more constraints for their cost
+ * first, fewer literals then
 */
-bool covers(int implicant, int constraint, int nOfVariables) {
-    for(int i = 0; i < nOfVariables; i++) {
-        if(!!(implicant & 0b11) && !!(constraint & 0b11) && (implicant & 0b11) != (constraint & 0b11)) return false; 
-        implicant >>=2;
-        constraint >>=2;
-    }
-    return true;
+bool betterBranch(int gainA, double costA, int literalsA, int gainB, double costB, int literalsB) {
+    double a = gainA * costB, b = gainB * costA;
+    if(a > b + COST_EPSILON || a < b - COST_EPSILON)
+        return a > b;
+    return literalsA < literalsB;
 }
 
 /**
- * Returns a int matrix representing the prime implicant chart.
- * Every row holds an implicant and every column a constraint: every
- * cell tells if the row implicant covers the column constraint
- * int** holds rows, int* holds columns
+ * Depth first search of the cheapest cover: the uncovered column with fewest available
+ * implicants is branched on, and every branch excludes the implicants already tried by
+ * the previous ones. Partial covers whose cost plus lower bound can't beat the best one
+ * are pruned. Among covers of the same cost the first one found is kept
 */
-chart_t* createChart(node_t* constraints, node_t* implicants, int nOfVariables) {
-    int rows = length(implicants)+1;
-    int cols = length(constraints)+1;
-    int col = 0;
-    node_t* cursor = constraints;
-    chart_t* implicantsChart = malloc(sizeof(chart_t));
+void searchCover(search_t* s, int uncovered, int depth, double cost) {
+    component_t* component = s->component;
+    int pivot = -1, tried = 0;
+    double bound;
 
-    implicantsChart->rows = rows;
-    implicantsChart->columns = cols;
-    implicantsChart->matrix = (int**) malloc((size_t) (sizeof(int)*rows));
+    if(component->nodeLimit > 0 && ++s->nodes > component->nodeLimit) {
+        component->exact = false;
+        return;
+    }
+    if(uncovered == 0) {
+        if(cost < component->solutionCost - COST_EPSILON) {
+            component->solutionCost = cost;
+            component->solutionSize = depth;
+            for(int idx = 0; idx < depth; idx++)
+                component->solution[idx] = s->selected[idx];
+        }
+        return;
+    }
+    int* removed = malloc(sizeof(int)*component->rows);
+    int nOfRemoved = excludeDominated(s, removed);
+    if((bound = lowerBound(s)) < 0 || cost + bound >= component->solutionCost - COST_EPSILON) {
+        while(nOfRemoved-- > 0)
+            excludeRow(s, removed[nOfRemoved], 1);
+        free(removed);
+        return;
+    }
+    for(int col = 0; col < component->columns; col++) {
+        if(s->coverCount[col] == 0 && (pivot == -1 || s->available[col] < s->available[pivot]))
+            pivot = col;
+    }
+    // most promising implicants first
+    int* branch = malloc(sizeof(int)*component->colSize[pivot]);
+    for(int idx = 0; idx < component->colSize[pivot]; idx++) {
+        int row = component->colRows[pivot][idx];
+        if(s->excluded[row])
+            continue;
+        int pos = tried++;
+        int rowLiterals = literals(component->implicants[row]);
+        while(pos > 0 && betterBranch(s->gain[row], component->rowCost[row], rowLiterals,
+                                      s->gain[branch[pos-1]], component->rowCost[branch[pos-1]], literals(component->implicants[branch[pos-1]]))) {
+            branch[pos] = branch[pos-1];
+            pos--;
+        }
+        branch[pos] = row;
+    }
+    for(int idx = 0; idx < tried; idx++) {
+        int row = branch[idx];
+        s->selected[depth] = row;
+        int covered = toggleRow(s, row, 1);
+        searchCover(s, uncovered - covered, depth + 1, cost + component->rowCost[row]);
+        toggleRow(s, row, -1);
+        excludeRow(s, row, -1);
+    }
+    while(tried-- > 0)
+        excludeRow(s, branch[tried], 1);
+    while(nOfRemoved-- > 0)
+        excludeRow(s, removed[nOfRemoved], 1);
+    free(branch);
+    free(removed);
+}
 
-    for(int idx = 0; idx < rows; idx++) {
-        implicantsChart->matrix[idx] = (int*) malloc((size_t) (sizeof(int)*cols));
-        if(idx == 0) {
-            implicantsChart->matrix[idx][0] = 0;
-            col = 1;
-            cursor = constraints;
-            while(cursor != NULL) {
-                implicantsChart->matrix[idx][col++] = getData(cursor);
-                cursor = next(cursor);
-            }
-        } else {
-            implicantsChart->matrix[idx][0] = getData(implicants);
-            col = 0;
-            while(++col < cols) {
-                implicantsChart->matrix[idx][col] = (int) covers(implicantsChart->matrix[idx][0], implicantsChart->matrix[0][col],nOfVariables);
+/**
+ * Finds a minimum cost cover of passed component. A greedy cover, taking every time the
+ * implicant covering most constraints for its cost, is used as the first upper bound
+ * of the search and is the result if the search runs out of nodes before beating it
+*/
+void solveComponent(component_t* component) {
+    search_t s;
+    int uncovered = component->columns;
+
+    s.component = component;
+    s.coverCount = calloc(component->columns, sizeof(int));
+    s.available = malloc(sizeof(int)*component->columns);
+    s.excluded = calloc(component->rows, sizeof(bool));
+    s.selected = malloc(sizeof(int)*(component->rows+1));
+    s.gain = malloc(sizeof(int)*component->rows);
+    s.order = malloc(sizeof(int)*component->columns);
+    s.mark = calloc(component->rows, sizeof(int));
+    s.colMark = calloc(component->columns, sizeof(int));
+    s.stamp = 0;
+    s.nodes = 0;
+    component->exact = true;
+    component->solution = malloc(sizeof(int)*(component->rows+1));
+    component->solutionSize = 0;
+    component->solutionCost = 0;
+    for(int col = 0; col < component->columns; col++)
+        s.available[col] = component->colSize[col];
+    while(uncovered > 0) { // greedy upper bound
+        int best = -1, bestGain = 0;
+        for(int row = 0; row < component->rows; row++) {
+            int gain = 0;
+            for(int idx = 0; idx < component->rowSize[row]; idx++)
+                gain += s.coverCount[component->rowCols[row][idx]] == 0;
+            if(gain > 0 && (best == -1 || gain * component->rowCost[best] > bestGain * component->rowCost[row] + COST_EPSILON)) {
+                best = row;
+                bestGain = gain;
             }
-            implicants = next(implicants);
         }
+        uncovered -= toggleRow(&s, best, 1);
+        component->solution[component->solutionSize++] = best;
+        component->solutionCost += component->rowCost[best];
     }
-    return implicantsChart;
+    for(int idx = 0; idx < component->solutionSize; idx++)
+        toggleRow(&s, component->solution[idx], -1);
+    searchCover(&s, component->columns, 0, 0);
+    free(s.coverCount);
+    free(s.available);
+    free(s.excluded);
+    free(s.selected);
+    free(s.gain);
+    free(s.order);
+    free(s.mark);
+    free(s.colMark);
 }
 
-node_t* petrick(node_t* constraints, node_t* implicants, int nOfVariables) {
-    int totalConstraints = length(constraints);
-    int totalImplicants = length(implicants);
-    bool noSimplification = false;
+void solveComponentTask(void* arg) {
+    solveComponent((component_t*) arg);
+}
+
+/**
+ * Covers every constraint left in the chart: the chart is split into independent
+ * components which are solved exactly on nOfThreads threads, biggest first. Solutions
+ * are appended to the essentials list in component order so the result doesn't depend
+ * on scheduling
+*/
+void solveCyclic(chart_t* implicantsChart, node_t** essentials, int nOfThreads, costModel_t* cost, long nodeLimit) {
+    int count;
+    component_t* components = findComponents(implicantsChart, &count, cost);
+    task_t* tasks = malloc(sizeof(task_t)*(count > 0 ? count : 1));
+    bool exact = true;
+
+    for(int idx = 0; idx < count; idx++) {
+        components[idx].nodeLimit = nodeLimit;
+        tasks[idx].run = solveComponentTask;
+        tasks[idx].arg = &components[idx];
+        tasks[idx].cost = (double) components[idx].rows * components[idx].columns;
+    }
+    runTasks(tasks, count, nOfThreads);
+
+    for(int idx = 0; idx < count; idx++) {
+        component_t* component = &components[idx];
+        exact = exact && component->exact;
+        for(int sol = 0; sol < component->solutionSize; sol++)
+            insertNode(essentials, component->implicants[component->solution[sol]], append);
+        for(int row = 0; row < component->rows; row++)
+            free(component->rowCols[row]);
+        for(int col = 0; col < component->columns; col++)
+            free(component->colRows[col]);
+        free(component->implicants);
+        free(component->rowCost);
+        free(component->rowCols);
+        free(component->rowSize);
+        free(component->colRows);
+        free(component->colSize);
+        free(component->solution);
+    }
+    if(!exact)
+        fprintf(stderr, "Warning: search limit reached, the cover may not be minimum\n");
+    free(components);
+    free(tasks);
+}
+
+node_t* petrick(node_t* constraints, node_t* implicants, int nOfVariables, int nOfThreads, costModel_t* cost, long nodeLimit) {
     node_t *essentials = NULL;
     chart_t* implicantsChart = createChart(constraints, implicants, nOfVariables);
-    while(totalConstraints > 0 && totalImplicants > 0 && !noSimplification) {
-        int ret = 0;
-        if(!!(ret = findEssentials(&implicantsChart,&essentials))) {
-            totalConstraints -= ret;
-            totalImplicants -= removeEmptyImplicants(&implicantsChart);
-            continue;
-        }
-        if(!!(ret = rowDominance(&implicantsChart, &essentials))) {
-            totalImplicants -= ret;
-            continue;
-        }
-        if(!!(ret = colDominance(&implicantsChart,&essentials))) {
-            totalConstraints -= ret;
-            totalImplicants -= removeEmptyImplicants(&implicantsChart);
-            continue;
-        }
-        noSimplification = true; // no simplification occurred
-    }    
-    if(noSimplification) {
-        printf("Cyclic table:\n"); 
-        printMatrix(implicantsChart->matrix,implicantsChart->rows,implicantsChart->columns, nOfVariables);
-    }
+    if(reduceChart(implicantsChart, &essentials, cost) > 0)
+        solveCyclic(implicantsChart, &essentials, nOfThreads, cost, nodeLimit);
+    freeChart(implicantsChart);
     return essentials;
 }
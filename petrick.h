@@ -1,10 +1,28 @@
 #ifndef _PETRICK
 #define _PETRICK
-typedef struct chart {
-    int** matrix;
+
+#define DEFAULT_NODE_LIMIT 10000 // nodes of the exact search of a component, 0 means no limit
+typedef struct component {
     int rows;
     int columns;
-} chart_t;
+    int* implicants;    // implicant of every row
+    double* rowCost;    // cost of the implicant of every row
+    int** rowCols;      // constraints covered by every row
+    int* rowSize;
+    int** colRows;      // implicants covering every column
+    int* colSize;
+    int* solution;      // rows of the minimum cover
+    int solutionSize;
+    double solutionCost;
+    long nodeLimit;     // nodes the exact search may visit, 0 means no limit
+    bool exact;         // false if the search ran out of nodes before proving the solution minimum
+} component_t;
 
-node_t* petrick(node_t* constraints, node_t* implicants, int nOfVariables);
+/**
+ * Returns a cover of the constraints made of passed implicants with minimum cost. Independent
+ * parts of the cyclic core are solved on nOfThreads threads; the exact search of each of them
+ * visits at most nodeLimit nodes (0: no limit) and keeps the best cover found so far when it
+ * runs out of them
+*/
+node_t* petrick(node_t* constraints, node_t* implicants, int nOfVariables, int nOfThreads, costModel_t* cost, long nodeLimit);
 #endif
\ No newline at end of file
@@ -0,0 +1,434 @@
+/**
+ * CUBE READERS
+ * Reads functions given as cubes (Espresso PLA or two-level BLIF) straight into
+ * lists of implicants in positional cube representation
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include "linkedlist.h"
+#include "main.h"
+#include "writer.h"
+#include "reader.h"
+
+void parseError(char* filename, int line, char* message) {
+    fprintf(stderr, "%s:%d: %s\n", filename, line, message);
+    exit(1);
+}
+
+int inputFormatFromName(char* name) {
+    if(strcmp(name, "pla") == 0) return INPUT_PLA;
+    if(strcmp(name, "blif") == 0) return INPUT_BLIF;
+    return -1;
+}
+
+function_t* createFunction(int nOfVariables, int nOfOutputs) {
+    function_t* function = malloc(sizeof(function_t));
+    function->nOfVariables = nOfVariables;
+    function->nOfOutputs = nOfOutputs;
+    function->onCubes = calloc(nOfOutputs, sizeof(node_t*));
+    function->dcCubes = calloc(nOfOutputs, sizeof(node_t*));
+    function->offCubes = calloc(nOfOutputs, sizeof(node_t*));
+    function->dcOffCubes = calloc(nOfOutputs, sizeof(node_t*));
+    function->hasOffSet = false;
+    function->names = readNames(NULL, nOfVariables, nOfOutputs);
+    return function;
+}
+
+void freeFunction(function_t* function) {
+    for(int out = 0; out < function->nOfOutputs; out++) {
+        removeList(&function->onCubes[out]);
+        removeList(&function->dcCubes[out]);
+        removeList(&function->offCubes[out]);
+        removeList(&function->dcOffCubes[out]);
+    }
+    free(function->onCubes);
+    free(function->dcCubes);
+    free(function->offCubes);
+    free(function->dcOffCubes);
+    freeNames(function->names);
+    free(function);
+}
+
+void addCube(node_t** cubes, int cube) {
+    if(insertNode(cubes, cube, prepend) == NULL) {
+        perror("Error while adding cubes\n");
+        exit(1);
+    }
+}
+
+void setName(char** name, char* value) {
+    free(*name);
+    *name = strdup(value);
+}
+
+/**
+ * Reads the next line of fp without comments and trailing whitespace, joining lines ending
+ * with a backslash. Returns false at the end of the file
+*/
+bool readLine(FILE* fp, char** line, size_t* size, int* lineNumber) {
+    char* part = NULL;
+    size_t partSize = 0;
+    size_t length = 0;
+    bool found = false;
+
+    while(getline(&part, &partSize, fp) != -1) {
+        (*lineNumber)++;
+        found = true;
+        char* comment = strchr(part, '#');
+        if(comment != NULL) *comment = '\0';
+        size_t partLength = strlen(part);
+        while(partLength > 0 && isspace((unsigned char) part[partLength-1]))
+            part[--partLength] = '\0';
+        bool continued = partLength > 0 && part[partLength-1] == '\\';
+        if(continued) part[partLength-1] = ' ';
+        if(length + partLength + 2 > *size) {
+            *size = length + partLength + 2;
+            *line = realloc(*line, *size);
+        }
+        memcpy(*line + length, part, partLength);
+        length += partLength;
+        (*line)[length] = '\0';
+        if(!continued) break;
+    }
+    free(part);
+    return found;
+}
+
+/**
+ * Returns the positional cube representation of the first nOfVariables symbols of str,
+ * first variable first. Returns -1 if a symbol isn't 0, 1 or -
+*/
+int parseCube(char* str, int nOfVariables) {
+    int cube = 0;
+    for(int k = 0; k < nOfVariables; k++) {
+        int pair = nOfVariables-1-k;
+        switch(str[k]) {
+            case '1':
+                cube |= ONE << (2*pair);
+                break;
+            case '0':
+                cube |= ZERO << (2*pair);
+                break;
+            case '-':
+                break;
+            default:
+                return -1;
+        }
+    }
+    return cube;
+}
+
+function_t* readPLA(char* filename) {
+    FILE* fp = fopen(filename, "r");
+    function_t* function = NULL;
+    char* line = NULL;
+    size_t size = 0;
+    int lineNumber = 0;
+    int nOfVariables = -1, nOfOutputs = 1;
+    char type[8] = "fd";
+
+    if(fp == NULL) {
+        perror("Error while opening file");
+        exit(1);
+    }
+    while(readLine(fp, &line, &size, &lineNumber)) {
+        char* cursor = line;
+        while(isspace((unsigned char) *cursor)) cursor++;
+        if(*cursor == '\0') continue;
+        if(*cursor == '.') {
+            char directive[16];
+            int offset = 0;
+            sscanf(cursor, "%15s%n", directive, &offset);
+            cursor += offset;
+            if(strcmp(directive, ".e") == 0 || strcmp(directive, ".end") == 0)
+                break;
+            if(strcmp(directive, ".i") == 0) {
+                if(function != NULL)
+                    parseError(filename, lineNumber, ".i must come before labels and cubes");
+                if(sscanf(cursor, "%d", &nOfVariables) != 1 || nOfVariables < MIN_VARIABLES || nOfVariables > MAX_VARIABLES)
+                    parseError(filename, lineNumber, "Number of variables must be between 1 and 15 (included)");
+            } else if(strcmp(directive, ".o") == 0) {
+                if(function != NULL)
+                    parseError(filename, lineNumber, ".o must come before labels and cubes");
+                if(sscanf(cursor, "%d", &nOfOutputs) != 1 || nOfOutputs < 1)
+                    parseError(filename, lineNumber, "Number of outputs must be at least 1");
+            } else if(strcmp(directive, ".type") == 0) {
+                if(sscanf(cursor, "%7s", type) != 1 || (strcmp(type, "f") && strcmp(type, "fd") && strcmp(type, "fr") && strcmp(type, "fdr")))
+                    parseError(filename, lineNumber, "Supported types are f, fd, fr, fdr");
+            } else if(strcmp(directive, ".ilb") == 0 || strcmp(directive, ".ob") == 0) {
+                if(nOfVariables == -1)
+                    parseError(filename, lineNumber, "Missing .i before labels");
+                if(function == NULL)
+                    function = createFunction(nOfVariables, nOfOutputs);
+                bool inputs = strcmp(directive, ".ilb") == 0;
+                char** list = inputs ? function->names->inputs : function->names->outputs;
+                int count = inputs ? nOfVariables : nOfOutputs;
+                char name[256];
+                for(int idx = 0; idx < count && sscanf(cursor, "%255s%n", name, &offset) == 1; idx++) {
+                    setName(&list[idx], name);
+                    cursor += offset;
+                }
+            }
+            continue; // .p and every other directive don't change the cover
+        }
+        if(nOfVariables == -1)
+            parseError(filename, lineNumber, "Missing .i before cubes");
+        if(function == NULL)
+            function = createFunction(nOfVariables, nOfOutputs);
+        // input and output parts, whitespace between them is optional
+        char* symbols = malloc(strlen(cursor) + 1);
+        int count = 0;
+        for(; *cursor != '\0'; cursor++) {
+            if(!isspace((unsigned char) *cursor))
+                symbols[count++] = *cursor;
+        }
+        symbols[count] = '\0';
+        int cube = count == nOfVariables + nOfOutputs ? parseCube(symbols, nOfVariables) : -1;
+        if(cube == -1)
+            parseError(filename, lineNumber, "Malformed cube");
+        for(int out = 0; out < nOfOutputs; out++) {
+            switch(symbols[nOfVariables + out]) {
+                case '1':
+                case '4':
+                    addCube(&function->onCubes[out], cube);
+                    break;
+                case '0':
+                    if(strchr(type, 'r') != NULL)
+                        addCube(&function->offCubes[out], cube);
+                    break;
+                case '-':
+                case '2':
+                    if(strchr(type, 'd') != NULL)
+                        addCube(&function->dcCubes[out], cube);
+                    break;
+                case '~':
+                    break;
+                default:
+                    parseError(filename, lineNumber, "Malformed output part");
+            }
+        }
+        free(symbols);
+    }
+    if(function == NULL) {
+        if(nOfVariables == -1)
+            parseError(filename, lineNumber, "Missing .i");
+        function = createFunction(nOfVariables, nOfOutputs);
+    }
+    function->hasOffSet = strchr(type, 'r') != NULL;
+    free(line);
+    fclose(fp);
+    return function;
+}
+
+/**
+ * Returns the index of name inside list, -1 if it isn't there
+*/
+int indexOf(char** list, int count, char* name) {
+    for(int idx = 0; idx < count; idx++) {
+        if(strcmp(list[idx], name) == 0)
+            return idx;
+    }
+    return -1;
+}
+
+/**
+ * Appends every whitespace separated name of str to list
+*/
+void appendNames(char*** list, int* count, char* str) {
+    char name[256];
+    int offset;
+    while(sscanf(str, "%255s%n", name, &offset) == 1) {
+        *list = realloc(*list, sizeof(char*)*(*count+1));
+        (*list)[(*count)++] = strdup(name);
+        str += offset;
+    }
+}
+
+function_t* readBLIF(char* filename) {
+    FILE* fp = fopen(filename, "r");
+    function_t* function = NULL;
+    char* line = NULL;
+    size_t size = 0;
+    int lineNumber = 0;
+    char** inputs = NULL;
+    char** outputs = NULL;
+    int nOfInputs = 0, nOfOutputs = 0;
+    int* blockInputs = NULL; // primary input of every input of the current .names
+    int blockSize = 0;
+    int blockOutput = -1;
+    char blockPhase = 0;     // output value of the rows of the current .names
+    bool exdc = false;
+
+    if(fp == NULL) {
+        perror("Error while opening file");
+        exit(1);
+    }
+    while(readLine(fp, &line, &size, &lineNumber)) {
+        char* cursor = line;
+        while(isspace((unsigned char) *cursor)) cursor++;
+        if(*cursor == '\0') continue;
+        if(*cursor == '.') {
+            char directive[16];
+            int offset = 0;
+            sscanf(cursor, "%15s%n", directive, &offset);
+            cursor += offset;
+            blockOutput = -1;
+            if(strcmp(directive, ".inputs") == 0) {
+                appendNames(&inputs, &nOfInputs, cursor);
+            } else if(strcmp(directive, ".outputs") == 0) {
+                appendNames(&outputs, &nOfOutputs, cursor);
+            } else if(strcmp(directive, ".exdc") == 0) {
+                exdc = true;
+            } else if(strcmp(directive, ".end") == 0) {
+                if(!exdc) break;
+                exdc = false;
+            } else if(strcmp(directive, ".names") == 0) {
+                char** names = NULL;
+                int count = 0;
+                appendNames(&names, &count, cursor);
+                if(count == 0)
+                    parseError(filename, lineNumber, "Missing .names output");
+                if(function == NULL) {
+                    if(nOfInputs < MIN_VARIABLES || nOfInputs > MAX_VARIABLES)
+                        parseError(filename, lineNumber, "Number of inputs must be between 1 and 15 (included)");
+                    if(nOfOutputs < 1)
+                        parseError(filename, lineNumber, "Missing .outputs");
+                    function = createFunction(nOfInputs, nOfOutputs);
+                    for(int idx = 0; idx < nOfInputs; idx++)
+                        setName(&function->names->inputs[idx], inputs[idx]);
+                    for(int idx = 0; idx < nOfOutputs; idx++)
+                        setName(&function->names->outputs[idx], outputs[idx]);
+                }
+                blockSize = count - 1;
+                blockInputs = realloc(blockInputs, sizeof(int)*(blockSize > 0 ? blockSize : 1));
+                for(int idx = 0; idx < blockSize; idx++) {
+                    if((blockInputs[idx] = indexOf(inputs, nOfInputs, names[idx])) == -1)
+                        parseError(filename, lineNumber, "Only covers of primary inputs are supported");
+                }
+                if((blockOutput = indexOf(outputs, nOfOutputs, names[blockSize])) == -1)
+                    parseError(filename, lineNumber, "Only covers of primary outputs are supported");
+                blockPhase = 0;
+                for(int idx = 0; idx < count; idx++)
+                    free(names[idx]);
+                free(names);
+            } else if(strcmp(directive, ".model") != 0) {
+                parseError(filename, lineNumber, "Only .model, .inputs, .outputs, .names and .exdc are supported");
+            }
+            continue;
+        }
+        if(blockOutput == -1)
+            parseError(filename, lineNumber, "Cube outside of .names");
+        char** tokens = NULL;
+        int count = 0;
+        appendNames(&tokens, &count, cursor);
+        if(count != (blockSize > 0 ? 2 : 1) || (blockSize > 0 && (int) strlen(tokens[0]) != blockSize))
+            parseError(filename, lineNumber, "Malformed cube");
+        char* plane = tokens[0];
+        char* value = tokens[count-1];
+        if((strcmp(value, "0") != 0 && strcmp(value, "1") != 0) || (blockPhase != 0 && blockPhase != value[0]))
+            parseError(filename, lineNumber, "Malformed output value");
+        blockPhase = value[0];
+        int cube = 0;
+        for(int idx = 0; idx < blockSize; idx++) {
+            int pair = nOfInputs-1-blockInputs[idx];
+            if(plane[idx] == '1') cube |= ONE << (2*pair);
+            else if(plane[idx] == '0') cube |= ZERO << (2*pair);
+            else if(plane[idx] != '-') parseError(filename, lineNumber, "Malformed cube");
+        }
+        for(int idx = 0; idx < count; idx++)
+            free(tokens[idx]);
+        free(tokens);
+        if(exdc)
+            addCube(blockPhase == '1' ? &function->dcCubes[blockOutput] : &function->dcOffCubes[blockOutput], cube);
+        else
+            addCube(blockPhase == '1' ? &function->onCubes[blockOutput] : &function->offCubes[blockOutput], cube);
+    }
+    if(function == NULL) {
+        if(nOfInputs < MIN_VARIABLES || nOfInputs > MAX_VARIABLES || nOfOutputs < 1)
+            parseError(filename, lineNumber, "Missing .inputs or .outputs");
+        function = createFunction(nOfInputs, nOfOutputs);
+        for(int idx = 0; idx < nOfInputs; idx++)
+            setName(&function->names->inputs[idx], inputs[idx]);
+        for(int idx = 0; idx < nOfOutputs; idx++)
+            setName(&function->names->outputs[idx], outputs[idx]);
+    }
+    for(int idx = 0; idx < nOfInputs; idx++)
+        free(inputs[idx]);
+    for(int idx = 0; idx < nOfOutputs; idx++)
+        free(outputs[idx]);
+    free(inputs);
+    free(outputs);
+    free(blockInputs);
+    free(line);
+    fclose(fp);
+    return function;
+}
+
+/**
+ * Sets to 1 the byte of every minterm of every cube of cubes
+*/
+void expandCubes(node_t* cubes, int nOfVariables, char* minterms) {
+    for(; cubes != NULL; cubes = next(cubes)) {
+        int value, dcMask, sub = 0;
+        decodeCube(getData(cubes), nOfVariables, &value, &dcMask);
+        do {
+            minterms[value | sub] = 1;
+            sub = (sub - dcMask) & dcMask;
+        } while(sub != 0);
+    }
+}
+
+/**
+ * Returns the list of the minterms set inside on or dc ordered by cardinality and
+ * value, as QuineMcCluskey method expects. Minterms of dc are marked as don't care
+*/
+node_t* mintermList(char* on, char* dc, int nOfVariables) {
+    node_t* list = NULL;
+    for(int card = nOfVariables; card >= 0; card--) {
+        for(int value = (1 << nOfVariables) - 1; value >= 0; value--) {
+            if((!on[value] && (dc == NULL || !dc[value])) || __builtin_popcount(value) != card)
+                continue;
+            node_t* current = insertNode(&list, toPositionalCube(value, nOfVariables), prepend);
+            if(current == NULL) {
+                perror("Error while adding minterms\n");
+                exit(1);
+            }
+            if(!on[value]) setDontCare(current, 1);
+        }
+    }
+    return list;
+}
+
+void functionMinterms(function_t* function, int output, node_t** constraints, node_t** minterms) {
+    int size = 1 << function->nOfVariables;
+    char* on = calloc(size, 1);
+    char* dc = calloc(size, 1);
+    char* off = calloc(size, 1);
+    char* dcOff = calloc(size, 1);
+    bool complemented = !function->hasOffSet && function->offCubes[output] != NULL;
+    bool dcComplemented = function->dcOffCubes[output] != NULL;
+
+    expandCubes(function->onCubes[output], function->nOfVariables, on);
+    expandCubes(function->dcCubes[output], function->nOfVariables, dc);
+    expandCubes(function->offCubes[output], function->nOfVariables, off);
+    expandCubes(function->dcOffCubes[output], function->nOfVariables, dcOff);
+    for(int m = 0; m < size; m++) {
+        if(function->hasOffSet && !on[m] && !off[m])
+            dc[m] = 1;
+        if(dcComplemented && !dcOff[m])
+            dc[m] = 1;
+        if(complemented)
+            on[m] = !off[m] && !dc[m];
+        dc[m] = dc[m] && !on[m];
+    }
+    *constraints = mintermList(on, NULL, function->nOfVariables);
+    *minterms = mintermList(on, dc, function->nOfVariables);
+    free(on);
+    free(dc);
+    free(off);
+    free(dcOff);
+}
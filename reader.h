@@ -0,0 +1,52 @@
+#ifndef _READER
+#define _READER
+
+#define INPUT_MINTERMS 0
+#define INPUT_PLA 1
+#define INPUT_BLIF 2
+
+/**
+ * Boolean function with one or more outputs given as cubes in positional cube
+ * representation. Every output has an ON and a DC cover; if hasOffSet is true the
+ * OFF cover is given too and every minterm not in ON or OFF is a don't care.
+ * Otherwise a not empty OFF cover means the ON set is its complement, and a not
+ * empty dcOffCubes cover means the DC set is its complement
+*/
+typedef struct function {
+    int nOfVariables;
+    int nOfOutputs;
+    node_t** onCubes;
+    node_t** dcCubes;
+    node_t** offCubes;
+    node_t** dcOffCubes;
+    bool hasOffSet;
+    names_t* names;
+} function_t;
+
+/**
+ * Returns the input format with passed name (pla, blif), -1 if there is none
+*/
+int inputFormatFromName(char* name);
+
+/**
+ * Reads an Espresso style PLA file (types f, fd, fr, fdr)
+*/
+function_t* readPLA(char* filename);
+
+/**
+ * Reads a BLIF file made of a single level of .names covers over the primary inputs.
+ * Covers inside the .exdc network are read as don't care
+*/
+function_t* readBLIF(char* filename);
+
+/**
+ * Expands the cubes of passed output into the list of its ON set minterms (constraints)
+ * and the list of its ON and DC set minterms, with DC ones marked as don't care
+*/
+void functionMinterms(function_t* function, int output, node_t** constraints, node_t** minterms);
+
+/**
+ * Frees passed function
+*/
+void freeFunction(function_t* function);
+#endif
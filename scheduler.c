@@ -0,0 +1,197 @@
+/**
+ * BATCH SCHEDULER
+ * Runs a batch of tasks with work stealing: tasks are sorted by decreasing cost and dealt
+ * to the worker with the lowest total cost (longest processing time first), every worker
+ * runs its own deque from the front and, once it is empty, steals from the back of the
+ * deque of the worker with the most work left. Threads beside the calling one are taken
+ * from a pool shared by every call and given back as soon as they find no more work
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "scheduler.h"
+
+static int idleThreads = 0;    // threads that can be added to a call of runTasks
+static pthread_mutex_t idleLock = PTHREAD_MUTEX_INITIALIZER;
+
+typedef struct worker {
+    int* tasks;         // indexes of the tasks, by decreasing cost
+    int head;
+    int tail;
+    double load;        // cost of the tasks still in the deque
+    pthread_mutex_t lock;
+} worker_t;
+
+typedef struct scheduler {
+    task_t* tasks;
+    worker_t* workers;
+    int nOfWorkers;
+} scheduler_t;
+
+typedef struct context {
+    scheduler_t* scheduler;
+    int id;
+} context_t;
+
+void setThreadLimit(int nOfThreads) {
+    pthread_mutex_lock(&idleLock);
+    idleThreads = nOfThreads > 1 ? nOfThreads - 1 : 0;
+    pthread_mutex_unlock(&idleLock);
+}
+
+/**
+ * Takes up to wanted threads from the idle ones and returns how many were taken
+*/
+int acquireThreads(int wanted) {
+    pthread_mutex_lock(&idleLock);
+    int taken = wanted < idleThreads ? wanted : idleThreads;
+    idleThreads -= taken > 0 ? taken : 0;
+    pthread_mutex_unlock(&idleLock);
+    return taken > 0 ? taken : 0;
+}
+
+void releaseThread() {
+    pthread_mutex_lock(&idleLock);
+    idleThreads++;
+    pthread_mutex_unlock(&idleLock);
+}
+
+int availableThreads() {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus < 1 ? 1 : (int) cpus;
+}
+
+/**
+ * Sorts tasks indexes by decreasing cost, ties by index so that the schedule is deterministic
+*/
+void sortTasks(task_t* tasks, int* order, int count) {
+    for(int idx = 1; idx < count; idx++) {
+        int current = order[idx];
+        int pos = idx;
+        while(pos > 0 && tasks[order[pos-1]].cost < tasks[current].cost) {
+            order[pos] = order[pos-1];
+            pos--;
+        }
+        order[pos] = current;
+    }
+}
+
+/**
+ * Returns the next task of passed worker, -1 if its deque is empty
+*/
+int popTask(scheduler_t* scheduler, worker_t* worker, bool steal) {
+    int task = -1;
+    pthread_mutex_lock(&worker->lock);
+    if(worker->head < worker->tail) {
+        task = steal ? worker->tasks[--worker->tail] : worker->tasks[worker->head++];
+        worker->load -= scheduler->tasks[task].cost;
+    }
+    pthread_mutex_unlock(&worker->lock);
+    return task;
+}
+
+/**
+ * Steals a task from the worker with the most work left, -1 if every deque is empty
+*/
+int stealTask(scheduler_t* scheduler, int thief) {
+    while(true) {
+        int victim = -1;
+        double maxLoad = 0;
+        for(int idx = 0; idx < scheduler->nOfWorkers; idx++) {
+            worker_t* worker = &scheduler->workers[idx];
+            pthread_mutex_lock(&worker->lock);
+            bool busy = worker->head < worker->tail;
+            double load = worker->load;
+            pthread_mutex_unlock(&worker->lock);
+            if(idx != thief && busy && (victim == -1 || load > maxLoad)) {
+                victim = idx;
+                maxLoad = load;
+            }
+        }
+        if(victim == -1)
+            return -1;
+        int task = popTask(scheduler, &scheduler->workers[victim], true);
+        if(task != -1)
+            return task;
+    }
+}
+
+void* workerLoop(void* arg) {
+    context_t* context = (context_t*) arg;
+    scheduler_t* scheduler = context->scheduler;
+    worker_t* worker = &scheduler->workers[context->id];
+    int task;
+
+    while((task = popTask(scheduler, worker, false)) != -1 || (task = stealTask(scheduler, context->id)) != -1)
+        scheduler->tasks[task].run(scheduler->tasks[task].arg);
+    if(context->id != 0)  // the calling thread isn't from the pool
+        releaseThread();
+    return NULL;
+}
+
+void runTasks(task_t* tasks, int count, int nOfThreads) {
+    scheduler_t scheduler;
+    context_t* contexts;
+    pthread_t* threads;
+    int* order;
+
+    if(nOfThreads > count)
+        nOfThreads = count;
+    nOfThreads = 1 + acquireThreads(nOfThreads - 1);
+    if(nOfThreads <= 1) {
+        for(int idx = 0; idx < count; idx++)
+            tasks[idx].run(tasks[idx].arg);
+        return;
+    }
+    order = malloc(sizeof(int)*count);
+    for(int idx = 0; idx < count; idx++)
+        order[idx] = idx;
+    sortTasks(tasks, order, count);
+
+    scheduler.tasks = tasks;
+    scheduler.nOfWorkers = nOfThreads;
+    scheduler.workers = malloc(sizeof(worker_t)*nOfThreads);
+    for(int idx = 0; idx < nOfThreads; idx++) {
+        scheduler.workers[idx].tasks = malloc(sizeof(int)*count);
+        scheduler.workers[idx].head = scheduler.workers[idx].tail = 0;
+        scheduler.workers[idx].load = 0;
+        pthread_mutex_init(&scheduler.workers[idx].lock, NULL);
+    }
+    for(int idx = 0; idx < count; idx++) {
+        worker_t* lightest = &scheduler.workers[0];
+        for(int w = 1; w < nOfThreads; w++) {
+            if(scheduler.workers[w].load < lightest->load)
+                lightest = &scheduler.workers[w];
+        }
+        lightest->tasks[lightest->tail++] = order[idx];
+        lightest->load += tasks[order[idx]].cost;
+    }
+
+    contexts = malloc(sizeof(context_t)*nOfThreads);
+    threads = malloc(sizeof(pthread_t)*nOfThreads);
+    for(int idx = 0; idx < nOfThreads; idx++) {
+        contexts[idx].scheduler = &scheduler;
+        contexts[idx].id = idx;
+    }
+    for(int idx = 1; idx < nOfThreads; idx++) {
+        if(pthread_create(&threads[idx], NULL, workerLoop, &contexts[idx]) != 0) {
+            perror("Error while creating worker thread");
+            exit(1);
+        }
+    }
+    workerLoop(&contexts[0]);
+    for(int idx = 1; idx < nOfThreads; idx++)
+        pthread_join(threads[idx], NULL);
+
+    for(int idx = 0; idx < nOfThreads; idx++) {
+        pthread_mutex_destroy(&scheduler.workers[idx].lock);
+        free(scheduler.workers[idx].tasks);
+    }
+    free(scheduler.workers);
+    free(contexts);
+    free(threads);
+    free(order);
+}
@@ -0,0 +1,33 @@
+#ifndef _SCHEDULER
+#define _SCHEDULER
+
+/**
+ * Unit of work of the scheduler: run(arg) is called once by one of the workers.
+ * cost is an estimate of its running time used to start the biggest tasks first
+*/
+typedef struct task {
+    void (*run)(void* arg);
+    void* arg;
+    double cost;
+} task_t;
+
+/**
+ * Returns the n. of online processors, at least 1
+*/
+int availableThreads();
+
+/**
+ * Sets the n. of threads running at once, the calling one included. runTasks never goes
+ * beyond it, nested calls included
+*/
+void setThreadLimit(int nOfThreads);
+
+/**
+ * Runs every task on up to nOfThreads threads (the calling one included) and returns when
+ * all of them are done. Only idle threads are added to the calling one, so a call made from
+ * inside a task only uses the threads that other tasks left free. Tasks must write their
+ * results to their own arg, so that the results don't depend on which thread ran them nor
+ * on the order they completed
+*/
+void runTasks(task_t* tasks, int count, int nOfThreads);
+#endif
@@ -0,0 +1,958 @@
+/**
+ * DIFFERENTIAL FUZZING AND PERFORMANCE HARNESS
+ * Runs the quineMcCluskey executable on random and edge case functions and compares its
+ * output against brute force oracles:
+ * - for n <= 8 the prime implicants are compared with the ones found by trying every cube
+ *   and the size of the cover with a minimum cover found by a plain exhaustive search, the
+ *   cost of the cover of the literals, gates and weighted literals cost models with the
+ *   cheapest found the same way
+ *   Random functions are kept sparse so that the search stays short, a fixed set of dense
+ *   functions of 5 and 6 variables checks charts with many overlapping primes
+ * - for 9 <= n <= 12 the prime implicants of the in memory and out of core methods are compared
+ * - functions of up to MAX_OUTPUTS outputs are written as PLA (types fd and fr) and BLIF (with a
+ *   complemented .exdc cover) files: reading them with -i must give the primes and covers of
+ *   the minterm files, and covers written with -o pla and -o blif must read back the same.
+ *   Their covers by gates with random weights and shared discount are checked by the oracle too
+ * - functions of MAX_OUTPUTS outputs up to 10 variables written as PLA files must give the same
+ *   binary output with 1 and 4 threads
+ * Then a fixed set of benchmarks is timed: a benchmark slower than its fixed budget fails the
+ * run. If a baseline file exists a benchmark slower than the baseline by more than the tolerance
+ * fails too, if it doesn't exist it is recorded for the next runs
+ *
+ * With -o only the checks against the oracles run, e.g. on builds forcing a chart representation
+ *
+ * usage: check [-o] executable [iterations] [seed] [baseline_filename]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/wait.h>
+
+#define ORACLE_VARIABLES 8
+#define MAX_DIFF_VARIABLES 12
+#define MAX_MINTERMS (1 << MAX_DIFF_VARIABLES)
+#define MAX_CUBES 6561      // 3^8
+#define MAX_OUTPUTS 4       // outputs of the functions written as PLA and BLIF files
+#define WORDS 4             // words of an oracle bitmap (256 minterms)
+#define TOLERANCE 2.0       // a benchmark fails if slower than baseline * TOLERANCE + SLACK
+#define SLACK 0.25
+#define ORACLE_MINTERMS 48   // ON and DC minterms of random functions, keeps the exhaustive cover search short
+#define DENSE_FUNCTIONS 16   // dense functions of 5 and 6 variables, generated from seeds 1, 2, ...
+
+typedef struct function {
+    int nOfVariables;
+    bool on[MAX_MINTERMS];
+    bool dc[MAX_MINTERMS];
+} function_t;
+
+typedef struct cubes {
+    int* data;
+    int count;
+} cubes_t;
+
+static char* executable;
+static char onFilename[64];
+static char dcFilename[64];
+static char outFilename[64];
+static char inputFilename[64];
+static char roundFilename[64];
+static int failures = 0;
+
+/**
+ * Minterm and cube symbols use the positional cube representation of the executable:
+ * variable i is pair i, 01 is x, 10 is x' and 00 is don't care
+*/
+int toCube(int value, int dcMask, int nOfVariables) {
+    int cube = 0;
+    for(int i = 0; i < nOfVariables; i++) {
+        if(dcMask >> i & 1) continue;
+        cube |= ((value >> i & 1) ? 0b01 : 0b10) << (2*i);
+    }
+    return cube;
+}
+
+void writeMinterms(char* filename, bool* set, int nOfVariables) {
+    FILE* fp = fopen(filename, "w");
+    if(fp == NULL) {
+        perror("Error while writing minterms file");
+        exit(1);
+    }
+    for(int m = 0; m < (1 << nOfVariables); m++) {
+        if(set[m]) fprintf(fp, "%d\n", m);
+    }
+    fclose(fp);
+}
+
+/**
+ * Returns n. of little endian bytes of fp as unsigned integer
+*/
+uint32_t readLE(FILE* fp, int size) {
+    uint32_t n = 0;
+    for(int i = 0; i < size; i++) {
+        int c = fgetc(fp);
+        if(c == EOF) return 0;
+        n |= (uint32_t) c << (8*i);
+    }
+    return n;
+}
+
+/**
+ * Runs the executable with passed flags and input arguments, its standard output going to
+ * output. Returns false if the executable failed
+*/
+bool execute(char* flags, char* input, char* output, double* seconds) {
+    char command[512];
+    struct timespec start, end;
+    int status;
+
+    snprintf(command, sizeof(command), "%s %s %s > %s", executable, flags, input, output);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    status = system(command);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if(seconds != NULL)
+        *seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    return status != -1 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**
+ * Runs the executable with passed flags and input arguments and reads the covers of its
+ * nOfOutputs outputs from its binary output. Returns false if the executable failed
+*/
+bool runInput(char* flags, char* input, cubes_t* results, int nOfOutputs, double* seconds) {
+    char binFlags[256];
+    char magic[4];
+    FILE* fp;
+
+    snprintf(binFlags, sizeof(binFlags), "-o bin %s", flags);
+    if(!execute(binFlags, input, outFilename, seconds))
+        return false;
+    if((fp = fopen(outFilename, "rb")) == NULL || fread(magic, 1, 4, fp) != 4 || memcmp(magic, "QMCB", 4) != 0) {
+        if(fp != NULL) fclose(fp);
+        return false;
+    }
+    readLE(fp, 1);
+    readLE(fp, 1);
+    if((int) readLE(fp, 2) != nOfOutputs) {
+        fclose(fp);
+        return false;
+    }
+    for(int out = 0; out < nOfOutputs; out++) {
+        results[out].count = readLE(fp, 4);
+        results[out].data = malloc(sizeof(int)*(results[out].count > 0 ? results[out].count : 1));
+        for(int idx = 0; idx < results[out].count; idx++)
+            results[out].data[idx] = readLE(fp, 4);
+    }
+    fclose(fp);
+    return true;
+}
+
+/**
+ * Runs the executable with passed flags on the minterm files of function and reads its
+ * binary output. Returns false if the executable failed
+*/
+bool run(char* flags, function_t* function, cubes_t* result, double* seconds) {
+    char input[192];
+    snprintf(input, sizeof(input), "%s %s %d", onFilename, dcFilename, function->nOfVariables);
+    return runInput(flags, input, result, 1, seconds);
+}
+
+int compareInts(const void* a, const void* b) {
+    int ia = *(const int*) a;
+    int ib = *(const int*) b;
+    return ia < ib ? -1 : ia > ib;
+}
+
+/**
+ * Returns true if a and b hold the same cubes in any order. The oracle primes stay in
+ * their order, matching the one of their bitmaps
+*/
+bool sameCubes(cubes_t* a, cubes_t* b) {
+    if(a->count != b->count) return false;
+    int* sortedA = malloc(sizeof(int)*(a->count > 0 ? a->count : 1));
+    int* sortedB = malloc(sizeof(int)*(b->count > 0 ? b->count : 1));
+    memcpy(sortedA, a->data, sizeof(int)*a->count);
+    memcpy(sortedB, b->data, sizeof(int)*b->count);
+    qsort(sortedA, a->count, sizeof(int), compareInts);
+    qsort(sortedB, b->count, sizeof(int), compareInts);
+    bool same = memcmp(sortedA, sortedB, sizeof(int)*a->count) == 0;
+    free(sortedA);
+    free(sortedB);
+    return same;
+}
+
+/**
+ * Bitmap of the minterms covered by the cube with passed value and dc mask
+*/
+void cubeBitmap(int value, int dcMask, int nOfVariables, uint64_t* bitmap) {
+    memset(bitmap, 0, sizeof(uint64_t)*WORDS);
+    for(int m = 0; m < (1 << nOfVariables); m++) {
+        if(((m ^ value) & ~dcMask) == 0)
+            bitmap[m/64] |= 1ULL << (m%64);
+    }
+}
+
+bool subset(uint64_t* a, uint64_t* b) {
+    for(int w = 0; w < WORDS; w++) {
+        if(a[w] & ~b[w]) return false;
+    }
+    return true;
+}
+
+bool intersects(uint64_t* a, uint64_t* b) {
+    for(int w = 0; w < WORDS; w++) {
+        if(a[w] & b[w]) return true;
+    }
+    return false;
+}
+
+/**
+ * Oracle of the prime implicants: every cube inside the ON and DC set that covers an ON
+ * minterm and that stops being inside the set if any of its literals is dropped
+*/
+void oraclePrimes(function_t* function, uint64_t* on, uint64_t* care, cubes_t* primes, uint64_t (*bitmaps)[WORDS]) {
+    int n = function->nOfVariables;
+    uint64_t bitmap[WORDS], bigger[WORDS];
+    primes->data = malloc(sizeof(int)*MAX_CUBES);
+    primes->count = 0;
+    for(int dcMask = 0; dcMask < (1 << n); dcMask++) {
+        for(int value = 0; value < (1 << n); value++) {
+            if(value & dcMask) continue;
+            cubeBitmap(value, dcMask, n, bitmap);
+            if(!subset(bitmap, care) || !intersects(bitmap, on)) continue;
+            bool prime = true;
+            for(int i = 0; i < n && prime; i++) {
+                if(dcMask >> i & 1) continue;
+                cubeBitmap(value & ~(1 << i), dcMask | (1 << i), n, bigger);
+                prime = !subset(bigger, care);
+            }
+            if(prime) {
+                memcpy(bitmaps[primes->count], bitmap, sizeof(bitmap));
+                primes->data[primes->count++] = toCube(value, dcMask, n);
+            }
+        }
+    }
+}
+
+/**
+ * Exhaustive search of a cover of uncovered with at most limit primes: every prime covering
+ * the uncovered minterm with the fewest covering primes is tried
+*/
+bool coverWithin(uint64_t (*bitmaps)[WORDS], int count, uint64_t* uncovered, int limit) {
+    int pivot = -1, pivotCount = count + 1;
+    for(int w = 0; w < WORDS; w++) {
+        for(uint64_t bits = uncovered[w]; bits != 0; bits &= bits - 1) {
+            int m = w*64 + __builtin_ctzll(bits), covering = 0;
+            for(int idx = 0; idx < count; idx++)
+                covering += bitmaps[idx][m/64] >> (m%64) & 1;
+            if(covering < pivotCount) {
+                pivot = m;
+                pivotCount = covering;
+            }
+        }
+    }
+    if(pivot == -1) return true;
+    if(limit == 0) return false;
+    for(int idx = 0; idx < count; idx++) {
+        if(!(bitmaps[idx][pivot/64] >> (pivot%64) & 1)) continue;
+        uint64_t left[WORDS];
+        for(int w = 0; w < WORDS; w++)
+            left[w] = uncovered[w] & ~bitmaps[idx][w];
+        if(coverWithin(bitmaps, count, left, limit-1)) return true;
+    }
+    return false;
+}
+
+/**
+ * Oracle of the minimum cover size: primes needed by a minterm covered by a single prime
+ * are taken, then covers of increasing size are tried on the remaining minterms
+*/
+int oracleCoverSize(uint64_t (*bitmaps)[WORDS], int count, uint64_t* on) {
+    uint64_t uncovered[WORDS];
+    int essentials = 0;
+    memcpy(uncovered, on, sizeof(uncovered));
+    for(int m = 0; m < 256; m++) {
+        int covering = -1, coverCount = 0;
+        if(!(on[m/64] >> (m%64) & 1)) continue;
+        for(int idx = 0; idx < count; idx++) {
+            if(bitmaps[idx][m/64] >> (m%64) & 1) {
+                covering = idx;
+                coverCount++;
+            }
+        }
+        if(coverCount == 1 && intersects(bitmaps[covering], uncovered)) {
+            for(int w = 0; w < WORDS; w++)
+                uncovered[w] &= ~bitmaps[covering][w];
+            essentials++;
+        }
+    }
+    for(int limit = 0; ; limit++) {
+        if(coverWithin(bitmaps, count, uncovered, limit))
+            return essentials + limit;
+    }
+}
+
+/**
+ * Exhaustive search of the cheapest cover of uncovered, cost[idx] being the cost of prime idx
+*/
+void cheapestCover(uint64_t (*bitmaps)[WORDS], int* cost, int count, uint64_t* uncovered, int partial, int* best) {
+    int pivot = -1, pivotCount = count + 1;
+    if(partial >= *best) return;
+    for(int w = 0; w < WORDS; w++) {
+        for(uint64_t bits = uncovered[w]; bits != 0; bits &= bits - 1) {
+            int m = w*64 + __builtin_ctzll(bits), covering = 0;
+            for(int idx = 0; idx < count; idx++)
+                covering += bitmaps[idx][m/64] >> (m%64) & 1;
+            if(covering < pivotCount) {
+                pivot = m;
+                pivotCount = covering;
+            }
+        }
+    }
+    if(pivot == -1) {
+        *best = partial;
+        return;
+    }
+    for(int idx = 0; idx < count; idx++) {
+        if(!(bitmaps[idx][pivot/64] >> (pivot%64) & 1)) continue;
+        uint64_t left[WORDS];
+        for(int w = 0; w < WORDS; w++)
+            left[w] = uncovered[w] & ~bitmaps[idx][w];
+        cheapestCover(bitmaps, cost, count, left, partial + cost[idx], best);
+    }
+}
+
+/**
+ * Cost model of the oracles in halves of a literal, so that the shared discount of 0.5 stays
+ * an integer: literals of variable k cost weights[k] (first variable first), literals of
+ * shared primes cost half, gates add an OR input for every cube and count the literals of
+ * cubes with more than one
+*/
+typedef struct oracleCost {
+    bool gates;
+    int weights[ORACLE_VARIABLES];
+    cubes_t* shared;
+} oracleCost_t;
+
+int cubeCost(oracleCost_t* model, int cube, int nOfVariables) {
+    int literals = 0, literalsCost = 0;
+    for(int i = 0; i < nOfVariables; i++) {
+        if(((cube >> (2*i)) & 0b11) == 0b00) continue;
+        literals++;
+        literalsCost += 2 * model->weights[nOfVariables-1-i];
+    }
+    if(model->shared != NULL && bsearch(&cube, model->shared->data, model->shared->count, sizeof(int), compareInts) != NULL)
+        literalsCost /= 2;
+    if(!model->gates) return literalsCost;
+    return 2 + (literals > 1 ? literalsCost : 0);
+}
+
+int coverCost(oracleCost_t* model, cubes_t* cover, int nOfVariables) {
+    int cost = 0;
+    for(int idx = 0; idx < cover->count; idx++)
+        cost += cubeCost(model, cover->data[idx], nOfVariables);
+    return cost;
+}
+
+/**
+ * Oracle of the cheapest cover made of prime implicants
+*/
+int oracleCoverCost(uint64_t (*bitmaps)[WORDS], cubes_t* primes, uint64_t* on, oracleCost_t* model, int nOfVariables) {
+    int* cost = malloc(sizeof(int)*(primes->count > 0 ? primes->count : 1));
+    int best = 0;
+    for(int idx = 0; idx < primes->count; idx++) {
+        cost[idx] = cubeCost(model, primes->data[idx], nOfVariables);
+        best += cost[idx];
+    }
+    best++;
+    cheapestCover(bitmaps, cost, primes->count, on, 0, &best);
+    free(cost);
+    return best;
+}
+
+/**
+ * Fills model with random weights from 1 to 3 and writes them as a -w argument into flags
+*/
+void randomWeights(oracleCost_t* model, int nOfVariables, char* flags, size_t size) {
+    int length = 0;
+    flags[0] = '\0';
+    for(int k = 0; k < nOfVariables; k++) {
+        model->weights[k] = 1 + rand() % 3;
+        length += snprintf(flags + length, size - length, "%s%d", k == 0 ? "-w " : ",", model->weights[k]);
+    }
+}
+
+/**
+ * Returns true if minterm m is inside cube
+*/
+bool insideCube(int cube, int m, int nOfVariables) {
+    for(int i = 0; i < nOfVariables; i++) {
+        int pair = (cube >> (2*i)) & 0b11;
+        if(pair != 0b00 && pair != ((m >> i & 1) ? 0b01 : 0b10)) return false;
+    }
+    return true;
+}
+
+/**
+ * Checks that cover covers every ON minterm and nothing outside the ON and DC set
+*/
+bool validCover(function_t* function, cubes_t* cover) {
+    bool covered[MAX_MINTERMS] = {false};
+    for(int idx = 0; idx < cover->count; idx++) {
+        for(int m = 0; m < (1 << function->nOfVariables); m++) {
+            if(!insideCube(cover->data[idx], m, function->nOfVariables)) continue;
+            if(!function->on[m] && !function->dc[m]) return false;
+            covered[m] = true;
+        }
+    }
+    for(int m = 0; m < (1 << function->nOfVariables); m++) {
+        if(function->on[m] && !covered[m]) return false;
+    }
+    return true;
+}
+
+void fail(int iteration, function_t* function, char* message) {
+    failures++;
+    printf("FAIL #%d n=%d: %s\n  on:", iteration, function->nOfVariables, message);
+    for(int m = 0; m < (1 << function->nOfVariables); m++)
+        if(function->on[m]) printf(" %d", m);
+    printf("\n  dc:");
+    for(int m = 0; m < (1 << function->nOfVariables); m++)
+        if(function->dc[m]) printf(" %d", m);
+    printf("\n");
+}
+
+/**
+ * Fills function with the edge case of passed index, returns false if there is none.
+ * Edge cases cover the smallest functions, empty and full sets, minterms that can't be
+ * joined and joined cubes reached from both DC and ON pairs
+*/
+bool edgeCase(int index, function_t* function) {
+    int n = 0;
+    memset(function, 0, sizeof(function_t));
+    switch(index) {
+        case 0: n = 1; break;                                       // empty ON set
+        case 1: n = 1; function->on[0] = function->on[1] = true; break;
+        case 2: n = 1; function->on[1] = function->dc[0] = true; break;
+        case 3: n = 4; for(int m = 0; m < 16; m++) function->dc[m] = true; break;
+        case 4: n = 8; for(int m = 0; m < 256; m++) function->on[m] = true; break;
+        case 5: n = 4;                                              // DC pairs join into a cube with ON minterms
+            for(int m = 0; m < 16; m++) function->dc[m] = true;
+            function->dc[1] = function->dc[7] = false;
+            function->on[1] = function->on[7] = true;
+            break;
+        case 6: n = 8; function->on[0] = true; break;
+        case 7: n = 8; for(int m = 0; m < 255; m++) function->dc[m] = true; function->on[255] = true; break;
+        case 8: n = 8; for(int m = 0; m < 256; m++) function->on[m] = __builtin_parity(m); break;
+        case 9: n = 3;                                              // cyclic chart
+            function->on[0] = function->on[1] = function->on[2] = function->on[5] = function->on[6] = function->on[7] = true;
+            break;
+        case 10: n = 8; function->on[0] = function->on[255] = true; break;
+        default: return false;
+    }
+    function->nOfVariables = n;
+    return true;
+}
+
+void randomFunction(function_t* function, int minVariables, int maxVariables, int maxMinterms) {
+    int n = minVariables + rand() % (maxVariables - minVariables + 1);
+    double pOn = (double) rand() / RAND_MAX;
+    double pDc = (double) rand() / RAND_MAX * (1 - pOn);
+    memset(function, 0, sizeof(function_t));
+    function->nOfVariables = n;
+    if(maxMinterms > 0 && (1 << n) * (pOn + pDc) > maxMinterms) {
+        double scale = maxMinterms / ((1 << n) * (pOn + pDc));
+        pOn *= scale;
+        pDc *= scale;
+    }
+    for(int m = 0; m < (1 << n); m++) {
+        double r = (double) rand() / RAND_MAX;
+        function->on[m] = r < pOn;
+        function->dc[m] = !function->on[m] && r < pOn + pDc;
+    }
+}
+
+/**
+ * Random function of n variables with about half of the minterms in the ON set
+*/
+void denseFunction(function_t* function, int n) {
+    double pOn = 0.35 + 0.3 * rand() / RAND_MAX;
+    double pDc = 0.2 * rand() / RAND_MAX;
+    memset(function, 0, sizeof(function_t));
+    function->nOfVariables = n;
+    for(int m = 0; m < (1 << n); m++) {
+        double r = (double) rand() / RAND_MAX;
+        function->on[m] = r < pOn;
+        function->dc[m] = !function->on[m] && r < pOn + pDc;
+    }
+}
+
+/**
+ * Checks primes and cover of function against the oracles
+*/
+void checkOracle(int iteration, function_t* function) {
+    static uint64_t bitmaps[MAX_CUBES][WORDS];
+    uint64_t on[WORDS] = {0}, care[WORDS] = {0};
+    cubes_t primes, outOfCorePrimes, expected, cover;
+
+    for(int m = 0; m < (1 << function->nOfVariables); m++) {
+        if(function->on[m]) on[m/64] |= 1ULL << (m%64);
+        if(function->on[m] || function->dc[m]) care[m/64] |= 1ULL << (m%64);
+    }
+    writeMinterms(onFilename, function->on, function->nOfVariables);
+    writeMinterms(dcFilename, function->dc, function->nOfVariables);
+    oraclePrimes(function, on, care, &expected, bitmaps);
+
+    if(!run("-p", function, &primes, NULL)) {
+        fail(iteration, function, "executable failed while generating primes");
+    } else {
+        if(!sameCubes(&primes, &expected))
+            fail(iteration, function, "primes differ from the oracle");
+        free(primes.data);
+    }
+    if(!run("-p -m 1", function, &outOfCorePrimes, NULL)) {
+        fail(iteration, function, "executable failed while generating primes out of core");
+    } else {
+        if(!sameCubes(&outOfCorePrimes, &expected))
+            fail(iteration, function, "out of core primes differ from the oracle");
+        free(outOfCorePrimes.data);
+    }
+    if(!run("", function, &cover, NULL)) {
+        fail(iteration, function, "executable failed while covering");
+    } else {
+        if(!validCover(function, &cover))
+            fail(iteration, function, "cover is wrong");
+        else if(cover.count != oracleCoverSize(bitmaps, expected.count, on))
+            fail(iteration, function, "cover isn't minimum");
+        free(cover.data);
+    }
+    // literals, gates and literals of random weights
+    for(int idx = 0; idx < 3; idx++) {
+        oracleCost_t model = {idx == 1, {0}, NULL};
+        char flags[64], weights[48] = "";
+        for(int k = 0; k < function->nOfVariables; k++)
+            model.weights[k] = 1;
+        if(idx == 2)
+            randomWeights(&model, function->nOfVariables, weights, sizeof(weights));
+        snprintf(flags, sizeof(flags), "-c %s %s", idx == 1 ? "gates" : "literals", weights);
+        if(!run(flags, function, &cover, NULL)) {
+            fail(iteration, function, "executable failed while covering by cost");
+        } else {
+            if(!validCover(function, &cover))
+                fail(iteration, function, "cover by cost is wrong");
+            else if(coverCost(&model, &cover, function->nOfVariables) != oracleCoverCost(bitmaps, &expected, on, &model, function->nOfVariables))
+                fail(iteration, function, "cover by cost isn't the cheapest");
+            free(cover.data);
+        }
+    }
+    free(expected.data);
+}
+
+/**
+ * Checks that in memory and out of core methods find the same primes on bigger functions
+*/
+void checkDifferential(int iteration, function_t* function) {
+    cubes_t inMemory, outOfCore;
+    writeMinterms(onFilename, function->on, function->nOfVariables);
+    writeMinterms(dcFilename, function->dc, function->nOfVariables);
+    if(!run("-p", function, &inMemory, NULL) || !run("-p -m 1", function, &outOfCore, NULL)) {
+        fail(iteration, function, "executable failed while generating primes");
+        return;
+    }
+    if(!sameCubes(&inMemory, &outOfCore))
+        fail(iteration, function, "in memory and out of core primes differ");
+    free(inMemory.data);
+    free(outOfCore.data);
+}
+
+/**
+ * Times the benchmarks and compares them with their budget and with the baseline file,
+ * records it if missing. Budgets are in seconds of the sanitized executable
+*/
+void checkPerformance(char* baselineFilename) {
+    static const struct { char* name; int n; int maxMinterms; char* flags; unsigned seed; double budget; } benchmarks[] = {
+        {"cover8", 8, 0, "", 1, 5.0},
+        {"cover10", 10, 200, "", 2, 1.0},
+        {"primes12", 12, 400, "-p", 3, 1.0},
+        {"outofcore12", 12, 400, "-p -m 1", 4, 1.0},
+    };
+    int count = sizeof(benchmarks)/sizeof(benchmarks[0]);
+    FILE* baseline = fopen(baselineFilename, "r");
+    FILE* record = NULL;
+    static function_t function;
+    cubes_t result;
+    char name[64];
+    double seconds, expected, value;
+
+    if(baseline == NULL && (record = fopen(baselineFilename, "w")) == NULL) {
+        perror("Error while writing baseline file");
+        exit(1);
+    }
+    for(int idx = 0; idx < count; idx++) {
+        srand(benchmarks[idx].seed);
+        randomFunction(&function, benchmarks[idx].n, benchmarks[idx].n, benchmarks[idx].maxMinterms);
+        writeMinterms(onFilename, function.on, function.nOfVariables);
+        writeMinterms(dcFilename, function.dc, function.nOfVariables);
+        if(!run(benchmarks[idx].flags, &function, &result, &seconds)) {
+            fail(idx, &function, "executable failed on benchmark");
+            continue;
+        }
+        free(result.data);
+        if(seconds > benchmarks[idx].budget) {
+            printf("%-12s %8.3fs OVER budget %.3fs\n", benchmarks[idx].name, seconds, benchmarks[idx].budget);
+            failures++;
+            continue;
+        }
+        if(record != NULL) {
+            fprintf(record, "%s %f\n", benchmarks[idx].name, seconds);
+            printf("%-12s %8.3fs (recorded)\n", benchmarks[idx].name, seconds);
+            continue;
+        }
+        rewind(baseline);
+        expected = -1;
+        while(fscanf(baseline, "%63s %lf", name, &value) == 2) {
+            if(strcmp(name, benchmarks[idx].name) == 0) {
+                expected = value;
+                break;
+            }
+        }
+        if(expected < 0) {
+            printf("%-12s %8.3fs (no baseline)\n", benchmarks[idx].name, seconds);
+        } else if(seconds > expected * TOLERANCE + SLACK) {
+            printf("%-12s %8.3fs SLOWER than baseline %.3fs\n", benchmarks[idx].name, seconds, expected);
+            failures++;
+        } else {
+            printf("%-12s %8.3fs (baseline %.3fs)\n", benchmarks[idx].name, seconds, expected);
+        }
+    }
+    if(baseline != NULL) fclose(baseline);
+    if(record != NULL) fclose(record);
+}
+
+/**
+ * Writes the symbols of minterm m, first variable first or last variable first if reversed
+*/
+void writeRow(FILE* fp, int m, int nOfVariables, bool reversed) {
+    for(int k = 0; k < nOfVariables; k++)
+        fputc('0' + (m >> (reversed ? k : nOfVariables-1-k) & 1), fp);
+}
+
+/**
+ * Writes the names of the variables, continuing the line with a backslash before the middle one
+*/
+void writeVariables(FILE* fp, int nOfVariables, bool reversed) {
+    for(int k = 0; k < nOfVariables; k++)
+        fprintf(fp, "%sx%d", k == 0 ? " " : k == nOfVariables/2 ? "\\\n" : " ", reversed ? nOfVariables-1-k : k);
+}
+
+FILE* openInput(char* filename) {
+    FILE* fp = fopen(filename, "w");
+    if(fp == NULL) {
+        perror("Error while writing input file");
+        exit(1);
+    }
+    return fp;
+}
+
+/**
+ * Writes functions as a PLA: type fd lists the ON and DC minterms, type fr the ON and OFF
+ * ones, the DC set being what is left
+*/
+void writePLAFile(char* filename, function_t* functions, int nOfOutputs, char* type) {
+    int n = functions[0].nOfVariables;
+    bool fr = strcmp(type, "fr") == 0;
+    FILE* fp = openInput(filename);
+    fprintf(fp, ".i %d\n.o %d\n.type %s\n", n, nOfOutputs, type);
+    for(int m = 0; m < (1 << n); m++) {
+        char symbols[MAX_OUTPUTS+1] = "";
+        bool used = false;
+        for(int out = 0; out < nOfOutputs; out++) {
+            if(functions[out].on[m]) symbols[out] = '1';
+            else if(functions[out].dc[m]) symbols[out] = fr ? '~' : '-';
+            else symbols[out] = fr ? '0' : '~';
+            used |= symbols[out] != '~';
+        }
+        if(!used) continue;
+        writeRow(fp, m, n, false);
+        fprintf(fp, " %s\n", symbols);
+    }
+    fprintf(fp, ".e\n");
+    fclose(fp);
+}
+
+/**
+ * Writes functions as a BLIF model whose covers list the inputs in reverse order. The DC set
+ * goes inside .exdc as the complement of a cover with output value 0, unless it is full
+*/
+void writeBLIFFile(char* filename, function_t* functions, int nOfOutputs) {
+    int n = functions[0].nOfVariables;
+    FILE* fp = openInput(filename);
+    fprintf(fp, ".model check\n.inputs");
+    writeVariables(fp, n, false);
+    fprintf(fp, "\n.outputs");
+    for(int out = 0; out < nOfOutputs; out++)
+        fprintf(fp, " f%d", out);
+    fprintf(fp, "\n");
+    for(int exdc = 0; exdc < 2; exdc++) {
+        if(exdc) fprintf(fp, ".exdc\n");
+        for(int out = 0; out < nOfOutputs; out++) {
+            bool full = true;
+            for(int m = 0; m < (1 << n); m++)
+                full &= functions[out].dc[m];
+            fprintf(fp, ".names");
+            writeVariables(fp, n, true);
+            fprintf(fp, " f%d\n", out);
+            for(int m = 0; m < (1 << n); m++) {
+                bool listed = !exdc ? functions[out].on[m] : full || !functions[out].dc[m];
+                if(!listed) continue;
+                writeRow(fp, m, n, true);
+                fprintf(fp, " %c\n", !exdc || full ? '1' : '0');
+            }
+        }
+    }
+    fprintf(fp, ".end\n");
+    fclose(fp);
+}
+
+void freeCovers(cubes_t* covers, int nOfOutputs) {
+    for(int out = 0; out < nOfOutputs; out++)
+        free(covers[out].data);
+}
+
+/**
+ * Checks the readers on functions written as PLA and BLIF files against the minterm files
+ * and the writers by reading back the covers they write
+*/
+void checkFormats(int iteration, function_t* functions, int nOfOutputs) {
+    static const struct { char* format; char* type; } inputs[] = {{"pla", "fd"}, {"pla", "fr"}, {"blif", NULL}};
+    static const char* outputs[] = {"pla", "blif"};
+    static function_t written;
+    cubes_t primes[MAX_OUTPUTS], covers[MAX_OUTPUTS], results[MAX_OUTPUTS];
+    char input[128], roundInput[128], flags[16];
+
+    for(int out = 0; out < nOfOutputs; out++) {
+        writeMinterms(onFilename, functions[out].on, functions[out].nOfVariables);
+        writeMinterms(dcFilename, functions[out].dc, functions[out].nOfVariables);
+        if(!run("-p", &functions[out], &primes[out], NULL) || !run("", &functions[out], &covers[out], NULL)) {
+            fail(iteration, &functions[out], "executable failed on minterm files");
+            freeCovers(primes, out);
+            freeCovers(covers, out);
+            return;
+        }
+    }
+    for(int idx = 0; idx < 3; idx++) {
+        if(inputs[idx].type != NULL) writePLAFile(inputFilename, functions, nOfOutputs, inputs[idx].type);
+        else writeBLIFFile(inputFilename, functions, nOfOutputs);
+        snprintf(input, sizeof(input), "-i %s %s", inputs[idx].format, inputFilename);
+        if(!runInput("-p", input, results, nOfOutputs, NULL)) {
+            fail(iteration, &functions[0], "executable failed while generating primes of an input file");
+        } else {
+            for(int out = 0; out < nOfOutputs; out++) {
+                if(!sameCubes(&results[out], &primes[out]))
+                    fail(iteration, &functions[out], "primes of an input file differ from the minterm files");
+            }
+            freeCovers(results, nOfOutputs);
+        }
+        if(!runInput("", input, results, nOfOutputs, NULL)) {
+            fail(iteration, &functions[0], "executable failed while covering an input file");
+        } else {
+            for(int out = 0; out < nOfOutputs; out++) {
+                if(!validCover(&functions[out], &results[out]) || results[out].count != covers[out].count)
+                    fail(iteration, &functions[out], "cover of an input file differs from the minterm files");
+            }
+            freeCovers(results, nOfOutputs);
+        }
+    }
+    // covers of the last input file, the BLIF one, are written in every format and read back
+    freeCovers(covers, nOfOutputs);
+    if(!runInput("", input, covers, nOfOutputs, NULL)) {
+        fail(iteration, &functions[0], "executable failed while covering an input file");
+        freeCovers(primes, nOfOutputs);
+        return;
+    }
+    for(int idx = 0; idx < 2; idx++) {
+        snprintf(flags, sizeof(flags), "-o %s", outputs[idx]);
+        snprintf(roundInput, sizeof(roundInput), "-i %s %s", outputs[idx], roundFilename);
+        if(!execute(flags, input, roundFilename, NULL) || !runInput("", roundInput, results, nOfOutputs, NULL)) {
+            fail(iteration, &functions[0], "executable failed while reading back a written cover");
+            continue;
+        }
+        for(int out = 0; out < nOfOutputs; out++) {
+            memset(&written, 0, sizeof(written));
+            written.nOfVariables = functions[out].nOfVariables;
+            for(int m = 0; m < (1 << written.nOfVariables); m++) {
+                for(int c = 0; c < covers[out].count && !written.on[m]; c++)
+                    written.on[m] = insideCube(covers[out].data[c], m, written.nOfVariables);
+            }
+            if(!validCover(&written, &results[out]))
+                fail(iteration, &functions[out], "cover read back differs from the written one");
+        }
+        freeCovers(results, nOfOutputs);
+    }
+    freeCovers(primes, nOfOutputs);
+    freeCovers(covers, nOfOutputs);
+}
+
+/**
+ * Checks the covers of the gates cost with random weights and a shared discount of 0.5
+ * against the oracle: primes of more than one output cost half of their literals
+*/
+void checkShared(int iteration, function_t* functions, int nOfOutputs) {
+    static uint64_t bitmaps[MAX_OUTPUTS][MAX_CUBES][WORDS];
+    uint64_t on[MAX_OUTPUTS][WORDS] = {{0}}, care[WORDS];
+    cubes_t primes[MAX_OUTPUTS], results[MAX_OUTPUTS], all, shared;
+    oracleCost_t model = {true, {0}, &shared};
+    int n = functions[0].nOfVariables;
+    char flags[80], weights[48], input[128];
+
+    all.count = shared.count = 0;
+    all.data = malloc(sizeof(int)*MAX_CUBES*nOfOutputs);
+    shared.data = malloc(sizeof(int)*MAX_CUBES*nOfOutputs);
+    for(int out = 0; out < nOfOutputs; out++) {
+        memset(care, 0, sizeof(care));
+        for(int m = 0; m < (1 << n); m++) {
+            if(functions[out].on[m]) on[out][m/64] |= 1ULL << (m%64);
+            if(functions[out].on[m] || functions[out].dc[m]) care[m/64] |= 1ULL << (m%64);
+        }
+        oraclePrimes(&functions[out], on[out], care, &primes[out], bitmaps[out]);
+        memcpy(all.data + all.count, primes[out].data, sizeof(int)*primes[out].count);
+        all.count += primes[out].count;
+    }
+    qsort(all.data, all.count, sizeof(int), compareInts);
+    for(int idx = 1; idx < all.count; idx++) {
+        if(all.data[idx] == all.data[idx-1] && (shared.count == 0 || shared.data[shared.count-1] != all.data[idx]))
+            shared.data[shared.count++] = all.data[idx];
+    }
+    randomWeights(&model, n, weights, sizeof(weights));
+    snprintf(flags, sizeof(flags), "-c gates -d 0.5 %s", weights);
+    writePLAFile(inputFilename, functions, nOfOutputs, "fd");
+    snprintf(input, sizeof(input), "-i pla %s", inputFilename);
+    if(!runInput(flags, input, results, nOfOutputs, NULL)) {
+        fail(iteration, &functions[0], "executable failed while covering with a shared discount");
+    } else {
+        for(int out = 0; out < nOfOutputs; out++) {
+            if(!validCover(&functions[out], &results[out]))
+                fail(iteration, &functions[out], "cover with a shared discount is wrong");
+            else if(coverCost(&model, &results[out], n) != oracleCoverCost(bitmaps[out], &primes[out], on[out], &model, n))
+                fail(iteration, &functions[out], "cover with a shared discount isn't the cheapest");
+        }
+        freeCovers(results, nOfOutputs);
+    }
+    freeCovers(primes, nOfOutputs);
+    free(all.data);
+    free(shared.data);
+}
+
+/**
+ * Returns true if the files with passed names hold the same bytes
+*/
+bool sameFiles(char* a, char* b) {
+    FILE* fa = fopen(a, "rb");
+    FILE* fb = fopen(b, "rb");
+    bool same = fa != NULL && fb != NULL;
+    while(same) {
+        int ca = fgetc(fa), cb = fgetc(fb);
+        same = ca == cb;
+        if(ca == EOF) break;
+    }
+    if(fa != NULL) fclose(fa);
+    if(fb != NULL) fclose(fb);
+    return same;
+}
+
+/**
+ * Checks that the output doesn't depend on the n. of threads
+*/
+void checkThreads(int iteration, function_t* functions, int nOfOutputs) {
+    char input[128];
+    writePLAFile(inputFilename, functions, nOfOutputs, "fd");
+    snprintf(input, sizeof(input), "-i pla %s", inputFilename);
+    if(!execute("-o bin -m 16 -b 500 -j 1", input, outFilename, NULL) || !execute("-o bin -m 16 -b 500 -j 4", input, roundFilename, NULL)) {
+        fail(iteration, &functions[0], "executable failed on a multiple output function");
+        return;
+    }
+    if(!sameFiles(outFilename, roundFilename))
+        fail(iteration, &functions[0], "output depends on the n. of threads");
+}
+
+int main(int argc, char* argv[]) {
+    bool oracleOnly = argc > 1 && strcmp(argv[1], "-o") == 0;
+    if(oracleOnly) {
+        argc--;
+        argv++;
+    }
+    int iterations = argc > 2 ? atoi(argv[2]) : 300;
+    unsigned seed = argc > 3 ? (unsigned) atoi(argv[3]) : (unsigned) time(NULL);
+    char* baselineFilename = argc > 4 ? argv[4] : "tests/baseline.txt";
+    int checked = DENSE_FUNCTIONS + iterations;
+    static function_t function;
+    static function_t functions[MAX_OUTPUTS];
+    char directory[] = "/tmp/qmcCheckXXXXXX";
+
+    if(argc < 2) {
+        fprintf(stderr, "Usage: check [-o] executable [iterations] [seed] [baseline_filename]\n");
+        exit(1);
+    }
+    executable = argv[1];
+    if(mkdtemp(directory) == NULL) {
+        perror("Error while creating temporary directory");
+        exit(1);
+    }
+    snprintf(onFilename, sizeof(onFilename), "%s/on.txt", directory);
+    snprintf(dcFilename, sizeof(dcFilename), "%s/dc.txt", directory);
+    snprintf(outFilename, sizeof(outFilename), "%s/out.bin", directory);
+    snprintf(inputFilename, sizeof(inputFilename), "%s/input", directory);
+    snprintf(roundFilename, sizeof(roundFilename), "%s/round", directory);
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    printf("seed %u\n", seed);
+    for(int idx = 0; edgeCase(idx, &function); idx++)
+        checkOracle(idx, &function);
+    for(int idx = 0; idx < DENSE_FUNCTIONS; idx++) {
+        srand(idx + 1);
+        denseFunction(&function, 5 + idx % 2);
+        checkOracle(idx, &function);
+    }
+    srand(seed);
+    for(int idx = 0; idx < iterations; idx++) {
+        randomFunction(&function, 1, ORACLE_VARIABLES, ORACLE_MINTERMS);
+        checkOracle(idx, &function);
+    }
+    if(oracleOnly)
+        iterations = 0;
+    checked += 2 * (iterations / 10) + iterations / 20;
+    for(int idx = 0; idx < iterations / 10; idx++) {
+        randomFunction(&function, ORACLE_VARIABLES + 1, MAX_DIFF_VARIABLES, 300);
+        checkDifferential(idx, &function);
+    }
+    for(int idx = 0; idx < iterations / 10; idx++) {
+        int nOfOutputs = 1 + rand() % MAX_OUTPUTS;
+        int n = 1 + rand() % ORACLE_VARIABLES;
+        for(int out = 0; out < nOfOutputs; out++)
+            randomFunction(&functions[out], n, n, ORACLE_MINTERMS);
+        checkFormats(idx, functions, nOfOutputs);
+        if(nOfOutputs > 1)
+            checkShared(idx, functions, nOfOutputs);
+    }
+    for(int idx = 0; idx < iterations / 20; idx++) {
+        int n = ORACLE_VARIABLES + rand() % 3;
+        for(int out = 0; out < MAX_OUTPUTS; out++)
+            randomFunction(&functions[out], n, n, 300);
+        checkThreads(idx, functions, MAX_OUTPUTS);
+    }
+    printf("%d functions checked, %d failures\n", checked, failures);
+    if(!oracleOnly)
+        checkPerformance(baselineFilename);
+
+    remove(onFilename);
+    remove(dcFilename);
+    remove(outFilename);
+    remove(inputFilename);
+    remove(roundFilename);
+    rmdir(directory);
+    return failures > 0;
+}
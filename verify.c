@@ -0,0 +1,121 @@
+/**
+ * COVER VERIFICATION
+ * Checks a cover against the ON and DC sets of its function using bitmaps with a bit for
+ * every minterm. A cube is expanded a word at a time: its first 6 variables select bits
+ * inside a word and the other ones select the words
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "linkedlist.h"
+#include "main.h"
+#include "verify.h"
+
+#define MAX_REPORTED 16
+
+// bits of a word whose minterm has variable i set, for the first 6 variables
+static const uint64_t variableMasks[] = {
+    0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+    0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+};
+
+int bitmapWords(int nOfVariables) {
+    return nOfVariables > 6 ? 1 << (nOfVariables - 6) : 1;
+}
+
+/**
+ * Returns the bits of a word that exist: all but when there are less than 64 minterms
+*/
+uint64_t validBits(int nOfVariables) {
+    return nOfVariables >= 6 ? ~0ULL : (1ULL << (1 << nOfVariables)) - 1;
+}
+
+uint64_t* createBitmap(int nOfVariables) {
+    uint64_t* bitmap = calloc(bitmapWords(nOfVariables), sizeof(uint64_t));
+    if(bitmap == NULL) {
+        perror("Error while allocating bitmap");
+        exit(1);
+    }
+    return bitmap;
+}
+
+/**
+ * Sets the bits of the minterms covered by the cube with passed value and dc mask
+*/
+void setCube(uint64_t* bitmap, int value, int dcMask, int nOfVariables) {
+    uint64_t pattern = validBits(nOfVariables);
+    int low = nOfVariables < 6 ? nOfVariables : 6;
+    for(int i = 0; i < low; i++) {
+        if(dcMask >> i & 1)
+            continue;
+        pattern &= (value >> i & 1) ? variableMasks[i] : ~variableMasks[i];
+    }
+    // words are indexed by the remaining variables: visit every subset of their dc ones
+    int wordDC = dcMask >> 6;
+    int word = (value >> 6) & ~wordDC;
+    int sub = 0;
+    do {
+        bitmap[word | sub] |= pattern;
+        sub = (sub - wordDC) & wordDC;
+    } while(sub != 0);
+}
+
+uint64_t* cubesBitmap(node_t* cubes, int nOfVariables) {
+    uint64_t* bitmap = createBitmap(nOfVariables);
+    int value, dcMask;
+    for(; cubes != NULL; cubes = next(cubes)) {
+        decodeCube(getData(cubes), nOfVariables, &value, &dcMask);
+        setCube(bitmap, value, dcMask, nOfVariables);
+    }
+    return bitmap;
+}
+
+verification_t* verifyCover(node_t* cover, uint64_t* on, uint64_t* care, int nOfVariables) {
+    verification_t* verification = malloc(sizeof(verification_t));
+    uint64_t* covered = cubesBitmap(cover, nOfVariables);
+    uint64_t valid = validBits(nOfVariables);
+
+    verification->nOfVariables = nOfVariables;
+    verification->uncovered = createBitmap(nOfVariables);
+    verification->offCovered = createBitmap(nOfVariables);
+    verification->errors = 0;
+    for(int w = 0; w < bitmapWords(nOfVariables); w++) {
+        verification->uncovered[w] = on[w] & ~covered[w];
+        verification->offCovered[w] = covered[w] & ~care[w] & valid;
+        verification->errors += __builtin_popcountll(verification->uncovered[w]);
+        verification->errors += __builtin_popcountll(verification->offCovered[w]);
+    }
+    free(covered);
+    return verification;
+}
+
+/**
+ * Writes the first minterms set in bitmap, returns how many have been written
+*/
+int reportMinterms(FILE* fp, uint64_t* bitmap, int nOfVariables, const char* message, int budget) {
+    int reported = 0;
+    for(int w = 0; w < bitmapWords(nOfVariables) && reported < budget; w++) {
+        for(uint64_t bits = bitmap[w]; bits != 0 && reported < budget; bits &= bits - 1) {
+            fprintf(fp, "  minterm %d %s\n", w*64 + __builtin_ctzll(bits), message);
+            reported++;
+        }
+    }
+    return reported;
+}
+
+void reportVerification(FILE* fp, verification_t* verification, char* output) {
+    int reported;
+    fprintf(fp, "Verification of %s failed: %ld wrong minterms\n", output, verification->errors);
+    reported = reportMinterms(fp, verification->uncovered, verification->nOfVariables, "of the ON set isn't covered", MAX_REPORTED);
+    reported += reportMinterms(fp, verification->offCovered, verification->nOfVariables, "of the OFF set is covered", MAX_REPORTED - reported);
+    if(verification->errors > reported)
+        fprintf(fp, "  ...\n");
+}
+
+void freeVerification(verification_t* verification) {
+    free(verification->uncovered);
+    free(verification->offCovered);
+    free(verification);
+}
@@ -0,0 +1,38 @@
+#ifndef _VERIFY
+#define _VERIFY
+#include <stdio.h>
+#include <stdint.h>
+
+/**
+ * Outcome of the check of a cover: bitmaps of the ON set minterms left uncovered and of
+ * the OFF set minterms covered, bit m of word m/64 stands for minterm m
+*/
+typedef struct verification {
+    int nOfVariables;
+    uint64_t* uncovered;
+    uint64_t* offCovered;
+    long errors;
+} verification_t;
+
+/**
+ * Returns the n. of 64 bit words of a bitmap with a bit for every minterm
+*/
+int bitmapWords(int nOfVariables);
+
+/**
+ * Returns the bitmap of the minterms covered by the cubes of passed list
+*/
+uint64_t* cubesBitmap(node_t* cubes, int nOfVariables);
+
+/**
+ * Checks that cover covers every minterm of on and none outside care (ON and DC set)
+*/
+verification_t* verifyCover(node_t* cover, uint64_t* on, uint64_t* care, int nOfVariables);
+
+/**
+ * Writes the offending minterms of a failed verification of passed output to fp
+*/
+void reportVerification(FILE* fp, verification_t* verification, char* output);
+
+void freeVerification(verification_t* verification);
+#endif
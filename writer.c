@@ -0,0 +1,306 @@
+/**
+ * COVER WRITERS
+ * Writes covers as text, Berkeley PLA, BLIF or binary cover. Every writer builds the
+ * whole output inside a buffer that is written at once
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "linkedlist.h"
+#include "main.h"
+#include "writer.h"
+
+static const char* defaultInputs[] = {"x", "y", "z", "w", "t", "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k"};
+
+typedef struct buffer {
+    char* data;
+    size_t size;
+    size_t capacity;
+} buffer_t;
+
+void reserve(buffer_t* buffer, size_t size) {
+    if(buffer->size + size <= buffer->capacity) return;
+    while(buffer->size + size > buffer->capacity)
+        buffer->capacity = buffer->capacity > 0 ? buffer->capacity*2 : 4096;
+    buffer->data = realloc(buffer->data, buffer->capacity);
+    if(buffer->data == NULL) {
+        perror("Error while allocating output buffer");
+        exit(1);
+    }
+}
+
+void appendBytes(buffer_t* buffer, const void* data, size_t size) {
+    reserve(buffer, size);
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+}
+
+void appendString(buffer_t* buffer, const char* str) {
+    appendBytes(buffer, str, strlen(str));
+}
+
+void appendChar(buffer_t* buffer, char c) {
+    reserve(buffer, 1);
+    buffer->data[buffer->size++] = c;
+}
+
+void appendInt(buffer_t* buffer, int n) {
+    char str[16];
+    snprintf(str, sizeof(str), "%d", n);
+    appendString(buffer, str);
+}
+
+/**
+ * Appends n as little endian unsigned integer of size bytes
+*/
+void appendLE(buffer_t* buffer, uint32_t n, int size) {
+    for(int i = 0; i < size; i++)
+        appendChar(buffer, (char) ((n >> (8*i)) & 0xFF));
+}
+
+/**
+ * Appends passed implicant replacing every pair of bits with its symbol, first variable first
+*/
+void appendCube(buffer_t* buffer, int n, int nOfVariables) {
+    static const char symbols[] = {'-', '1', '0', '~'};
+    reserve(buffer, nOfVariables);
+    for(int i = nOfVariables-1; i >= 0; i--)
+        buffer->data[buffer->size++] = symbols[(n >> (2*i)) & 0b11];
+}
+
+/**
+ * Appends passed implicant using Boolean algebra notation
+*/
+void appendImplicantVariables(buffer_t* buffer, int n, int nOfVariables, names_t* names) {
+    int var = 0;
+    for(int i = nOfVariables-1; i >= 0; i--, var++) {
+        switch((n >> (2*i)) & 0b11) {
+            case ONE:
+                appendString(buffer, names->inputs[var]);
+                break;
+            case ZERO:
+                appendString(buffer, names->inputs[var]);
+                appendChar(buffer, '\'');
+                break;
+        }
+    }
+}
+
+void appendNameList(buffer_t* buffer, char** list, int count) {
+    for(int idx = 0; idx < count; idx++) {
+        appendChar(buffer, ' ');
+        appendString(buffer, list[idx]);
+    }
+}
+
+void writeText(buffer_t* buffer, node_t** covers, int nOfOutputs, int nOfVariables, names_t* names) {
+    for(int out = 0; out < nOfOutputs; out++) {
+        if(nOfOutputs > 1) {
+            appendString(buffer, out > 0 ? "\n\n" : "");
+            appendString(buffer, names->outputs[out]);
+            appendString(buffer, ":\n");
+        }
+        appendString(buffer, "Essential implicants:\n");
+        for(node_t* cursor = covers[out]; cursor != NULL; cursor = next(cursor)) {
+            appendCube(buffer, getData(cursor), nOfVariables);
+            appendChar(buffer, '\t');
+            appendImplicantVariables(buffer, getData(cursor), nOfVariables, names);
+            appendChar(buffer, '\n');
+        }
+        appendString(buffer, "\nPoS form:\n");
+        for(node_t* cursor = covers[out]; cursor != NULL; cursor = next(cursor)) {
+            appendImplicantVariables(buffer, getData(cursor), nOfVariables, names);
+            if(next(cursor) != NULL)
+                appendString(buffer, nOfVariables<8 ? " + " : " +\n");
+        }
+    }
+}
+
+typedef struct term {
+    int cube;
+    int output;
+    int order;  // position of the first occurrence
+    int row;    // row of the outputs of the cube
+} term_t;
+
+int compareTerms(const void* a, const void* b) {
+    const term_t* ta = (const term_t*) a;
+    const term_t* tb = (const term_t*) b;
+    if(ta->cube != tb->cube) return ta->cube < tb->cube ? -1 : 1;
+    return ta->order - tb->order;
+}
+
+int compareOrder(const void* a, const void* b) {
+    return ((const term_t*) a)->order - ((const term_t*) b)->order;
+}
+
+/**
+ * Writes a single PLA with a row for every distinct cube: cubes shared by
+ * several outputs are written once with all their outputs set
+*/
+void writePLA(buffer_t* buffer, node_t** covers, int nOfOutputs, int nOfVariables, names_t* names) {
+    size_t count = 0, distinct = 0;
+    size_t width = nOfOutputs > 0 ? (size_t) nOfOutputs : 1; // bytes of the outputs of a row
+    for(int out = 0; out < nOfOutputs; out++)
+        count += (size_t) length(covers[out]);
+    term_t* terms = malloc(sizeof(term_t)*(count > 0 ? count : 1));
+    char* outputs = malloc(width*(count > 0 ? count : 1));
+    count = 0;
+    for(int out = 0; out < nOfOutputs; out++) {
+        for(node_t* cursor = covers[out]; cursor != NULL; cursor = next(cursor)) {
+            terms[count].cube = getData(cursor);
+            terms[count].output = out;
+            terms[count].order = (int) count;
+            count++;
+        }
+    }
+    // group equal cubes, keeping the position of their first occurrence
+    qsort(terms, count, sizeof(term_t), compareTerms);
+    for(size_t idx = 0; idx < count; idx++) {
+        if(distinct == 0 || terms[distinct-1].cube != terms[idx].cube) {
+            memset(outputs + distinct*width, '0', width);
+            terms[distinct++] = terms[idx];
+        }
+        outputs[(distinct-1)*width + terms[idx].output] = '1';
+        terms[distinct-1].row = (int) (distinct-1);
+    }
+    qsort(terms, distinct, sizeof(term_t), compareOrder);
+
+    appendString(buffer, ".i ");
+    appendInt(buffer, nOfVariables);
+    appendString(buffer, "\n.o ");
+    appendInt(buffer, nOfOutputs);
+    appendString(buffer, "\n.ilb");
+    appendNameList(buffer, names->inputs, nOfVariables);
+    appendString(buffer, "\n.ob");
+    appendNameList(buffer, names->outputs, nOfOutputs);
+    appendString(buffer, "\n.p ");
+    appendInt(buffer, (int) distinct);
+    appendChar(buffer, '\n');
+    for(size_t idx = 0; idx < distinct; idx++) {
+        appendCube(buffer, terms[idx].cube, nOfVariables);
+        appendChar(buffer, ' ');
+        appendBytes(buffer, outputs + (size_t) terms[idx].row*width, width);
+        appendChar(buffer, '\n');
+    }
+    appendString(buffer, ".e\n");
+    free(terms);
+    free(outputs);
+}
+
+void writeBLIF(buffer_t* buffer, node_t** covers, int nOfOutputs, int nOfVariables, names_t* names) {
+    appendString(buffer, ".model quineMcCluskey\n.inputs");
+    appendNameList(buffer, names->inputs, nOfVariables);
+    appendString(buffer, "\n.outputs");
+    appendNameList(buffer, names->outputs, nOfOutputs);
+    appendChar(buffer, '\n');
+    for(int out = 0; out < nOfOutputs; out++) {
+        appendString(buffer, ".names");
+        appendNameList(buffer, names->inputs, nOfVariables);
+        appendChar(buffer, ' ');
+        appendString(buffer, names->outputs[out]);
+        appendChar(buffer, '\n');
+        for(node_t* cursor = covers[out]; cursor != NULL; cursor = next(cursor)) {
+            appendCube(buffer, getData(cursor), nOfVariables);
+            appendString(buffer, " 1\n");
+        }
+    }
+    appendString(buffer, ".end\n");
+}
+
+void writeBinary(buffer_t* buffer, node_t** covers, int nOfOutputs, int nOfVariables) {
+    appendString(buffer, BINARY_MAGIC);
+    appendLE(buffer, BINARY_VERSION, 1);
+    appendLE(buffer, nOfVariables, 1);
+    appendLE(buffer, nOfOutputs, 2);
+    for(int out = 0; out < nOfOutputs; out++) {
+        appendLE(buffer, length(covers[out]), 4);
+        for(node_t* cursor = covers[out]; cursor != NULL; cursor = next(cursor))
+            appendLE(buffer, getData(cursor), 4);
+    }
+}
+
+void writeCovers(FILE* fp, int format, node_t** covers, int nOfOutputs, int nOfVariables, names_t* names) {
+    buffer_t buffer = {NULL, 0, 0};
+
+    switch(format) {
+        case FORMAT_PLA:
+            writePLA(&buffer, covers, nOfOutputs, nOfVariables, names);
+            break;
+        case FORMAT_BLIF:
+            writeBLIF(&buffer, covers, nOfOutputs, nOfVariables, names);
+            break;
+        case FORMAT_BINARY:
+            writeBinary(&buffer, covers, nOfOutputs, nOfVariables);
+            break;
+        default:
+            writeText(&buffer, covers, nOfOutputs, nOfVariables, names);
+            break;
+    }
+    if(buffer.size > 0 && fwrite(buffer.data, 1, buffer.size, fp) != buffer.size) {
+        perror("Error while writing output");
+        exit(1);
+    }
+    fflush(fp);
+    free(buffer.data);
+}
+
+int formatFromName(char* name) {
+    static const char* formats[] = {"text", "pla", "blif", "bin"};
+    for(int idx = 0; idx < (int) (sizeof(formats)/sizeof(formats[0])); idx++) {
+        if(strcmp(name, formats[idx]) == 0)
+            return idx;
+    }
+    return -1;
+}
+
+/**
+ * Returns a copy of the next whitespace separated word of fp, NULL at the end of the file
+*/
+char* readWord(FILE* fp) {
+    char word[256];
+    if(fp == NULL || fscanf(fp, "%255s", word) != 1)
+        return NULL;
+    return strdup(word);
+}
+
+names_t* readNames(char* filename, int nOfVariables, int nOfOutputs) {
+    names_t* names = malloc(sizeof(names_t));
+    FILE* fp = NULL;
+    char name[16];
+
+    if(filename != NULL && (fp = fopen(filename, "r")) == NULL) {
+        perror("Error while opening names file");
+        exit(1);
+    }
+    names->nOfInputs = nOfVariables;
+    names->nOfOutputs = nOfOutputs;
+    names->inputs = malloc(sizeof(char*)*nOfVariables);
+    names->outputs = malloc(sizeof(char*)*nOfOutputs);
+    for(int idx = 0; idx < nOfVariables; idx++) {
+        if((names->inputs[idx] = readWord(fp)) == NULL)
+            names->inputs[idx] = strdup(defaultInputs[idx]);
+    }
+    for(int idx = 0; idx < nOfOutputs; idx++) {
+        if((names->outputs[idx] = readWord(fp)) == NULL) {
+            snprintf(name, sizeof(name), "f%d", idx);
+            names->outputs[idx] = strdup(name);
+        }
+    }
+    if(fp != NULL)
+        fclose(fp);
+    return names;
+}
+
+void freeNames(names_t* names) {
+    for(int idx = 0; idx < names->nOfInputs; idx++)
+        free(names->inputs[idx]);
+    for(int idx = 0; idx < names->nOfOutputs; idx++)
+        free(names->outputs[idx]);
+    free(names->inputs);
+    free(names->outputs);
+    free(names);
+}
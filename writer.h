@@ -0,0 +1,51 @@
+#ifndef _WRITER
+#define _WRITER
+#include <stdio.h>
+
+#define FORMAT_TEXT 0
+#define FORMAT_PLA 1
+#define FORMAT_BLIF 2
+#define FORMAT_BINARY 3
+
+/**
+ * Binary cover format (little endian):
+ * - magic "QMCB", version (1 byte), n. of variables (1 byte), n. of outputs (2 bytes)
+ * - for every output: n. of cubes (4 bytes) followed by the cubes (4 bytes each)
+ *   in positional cube representation
+*/
+#define BINARY_MAGIC "QMCB"
+#define BINARY_VERSION 1
+
+/**
+ * Names of the input variables and of the outputs
+*/
+typedef struct names {
+    char** inputs;
+    int nOfInputs;
+    char** outputs;
+    int nOfOutputs;
+} names_t;
+
+/**
+ * Returns the names table read from passed file: names are separated by whitespace, the
+ * first nOfVariables are the inputs and the following ones the outputs. Missing names
+ * get a default one. If filename is NULL every name is a default one
+*/
+names_t* readNames(char* filename, int nOfVariables, int nOfOutputs);
+
+/**
+ * Frees passed names table
+*/
+void freeNames(names_t* names);
+
+/**
+ * Returns the format with passed name (text, pla, blif, bin), -1 if there is none
+*/
+int formatFromName(char* name);
+
+/**
+ * Writes the covers of nOfOutputs outputs to fp in passed format. The whole output is
+ * built inside a buffer and written with a single write
+*/
+void writeCovers(FILE* fp, int format, node_t** covers, int nOfOutputs, int nOfVariables, names_t* names);
+#endif